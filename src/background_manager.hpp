@@ -2,31 +2,98 @@
 
 #include "sky_environment.hpp"
 #include "camera_controller.hpp"
+#include "sky_switcher.hpp"
 
 // Respons?vel por carregar e atualizar o background (VDP2)
 struct BackgroundManager
 {
     SkyEnvironment env;
+    SkySwitcher switcher; // troca de ceu (hora do dia/clima) sem travar o frame
     bool loaded = false;
+    bool split = false;
+    uint16_t secondLine = 0; // linha da tabela do ceu onde o segundo viewport comeca; 0 = lado a lado
 
     void Configure()
     {
         env.useDome = false;
         env.useHorizon = true;
+        env.useGround = true;
         env.Configure();
     }
 
-    bool Init(const char* const* paths, size_t count)
+    bool Init(const char* const* paths, size_t count,
+              const char* const* groundPaths = nullptr, size_t groundCount = 0)
     {
         Configure();
-        env.Load(paths, count);
+        if (groundPaths != nullptr)
+            env.LoadGround(groundPaths, groundCount);
+        // Ceu pre-convertido (.SKY): uma leitura + um DMA direto na regiao do switcher
+        bool horizonLoaded = env.useHorizon && switcher.Init() && switcher.LoadNow(paths, count, env.horizon);
+        env.Load(paths, count, horizonLoaded);
         loaded = true;
         return true;
     }
 
+    // Comeca a troca para outro ceu; a transicao termina sozinha em alguns frames
+    bool RequestSky(const char* const* paths, size_t count)
+    {
+        if (!loaded || !env.useHorizon) return false;
+        return switcher.Request(paths, count);
+    }
+
     void Update(const Camera::State& camera)
     {
         if (!loaded) return;
         env.Update(camera.yawDeg, camera.viewYawDeg, camera.viewPitchDeg);
+        if (!split)
+            env.UpdateGround(camera);
+        if (env.useHorizon)
+            switcher.Update(env.horizon);
+    }
+
+    /** @brief Tela dividida: ceu do segundo viewport no NBG1 e chao RBG0 desligado
+     * (o RBG0 tem uma transformacao so para a tela inteira)
+     * @param tableLine Linha da tabela de line scroll onde o segundo viewport comeca (SplitScreen::SkySecondLine)
+     * @param rowOffset Deslocamento do ceu do viewport 0 (SplitScreen::SkyRowOffset)
+     * @return false se uma troca de ceu esta em andamento (tentar de novo depois)
+     */
+    bool SetSplit(bool on, uint16_t tableLine, int32_t rowOffset)
+    {
+        if (!loaded) return false;
+        if (on != split)
+        {
+            if (on && env.useHorizon && !switcher.BeginSplit(env.horizon, tableLine != 0)) return false;
+            if (!on)
+            {
+                switcher.EndSplit();
+                env.horizon.EndSecondView();
+            }
+
+            split = on;
+            if (env.useGround && env.ground.loaded)
+            {
+                if (on) SRL::VDP2::RBG0::ScrollDisable();
+                else SRL::VDP2::RBG0::ScrollEnable();
+            }
+        }
+        secondLine = on ? tableLine : 0;
+        env.horizon.rowOffset = on ? rowOffset : 0;
+        if (on) switcher.ApplySplit(env.horizon, secondLine != 0);
+        return true;
+    }
+
+    // 224/448i: NBG0 e, na tela dividida, o NBG1 do segundo viewport
+    void SetLineDoubling(bool on)
+    {
+        env.horizon.SetLineDoubling(on);
+        if (split) switcher.ApplySplit(env.horizon, secondLine != 0);
+    }
+
+    // Scroll do ceu do segundo viewport; antes do Update (a tabela de line scroll sai com os dois)
+    void UpdateSecond(const Camera::State& camera, int32_t rowOffset)
+    {
+        if (!loaded || !split || !env.useHorizon) return;
+        uint16_t firstLine = secondLine != 0 ? secondLine : (uint16_t)SkyBackground::MaxLines;
+        switcher.UpdateSplit(env.horizon.SecondView(firstLine, camera.yawDeg + camera.viewYawDeg, camera.viewPitchDeg, rowOffset));
     }
 };
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <srl.hpp>
+#include "camera_chase.hpp"
+#include "track_collision.hpp"
+#include "work_ram.hpp"
+
+// Sombra de carro em um poligono so: quad escuro com MESHon (meio transparente em xadrez) do tamanho da
+// pegada do carro, com cada canto apoiado na altura do chao do indice de colisao. SORT_MAX o ordena como
+// as faces de chao da pista (pelo vertice mais distante): fica sobre o asfalto e atras da carroceria.
+// A mesma malha serve para todos os carros; o SGL transforma os vertices na hora do DrawMesh.
+struct BlobShadow
+{
+    struct Config
+    {
+        SRL::Math::Types::Fxp halfWidth = SRL::Math::Types::Fxp(2.0f);   // X do carro
+        SRL::Math::Types::Fxp halfLength = SRL::Math::Types::Fxp(4.0f);  // Z do carro
+        SRL::Math::Types::Fxp lift = SRL::Math::Types::Fxp(0.25f);       // acima do chao (Y+ para baixo)
+        uint16_t color = C_RGB(0, 0, 0);
+    };
+
+    Config config;
+    SRL::Types::Mesh quad = SRL::Types::Mesh(4, 1);
+
+    /** @brief Monta o quad (uma vez)
+     * @param minV Canto minimo do modelo do carro
+     * @param maxV Canto maximo do modelo do carro
+     */
+    WORKRAM_COLD void Init(const SRL::Math::Types::Vector3D& minV, const SRL::Math::Types::Vector3D& maxV)
+    {
+        config.halfWidth = (maxV.X - minV.X) / SRL::Math::Types::Fxp::Convert(2);
+        config.halfLength = (maxV.Z - minV.Z) / SRL::Math::Types::Fxp::Convert(2);
+
+        quad.Faces[0].Normal = SRL::Math::Types::Vector3D(0.0f, -1.0f, 0.0f);
+        for (size_t v = 0; v < 4; ++v) quad.Faces[0].Vertices[v] = (uint16_t)v;
+
+        #pragma GCC diagnostic push
+        #pragma GCC diagnostic ignored "-Wnarrowing"
+        quad.Attributes[0] = SRL::Types::Attribute(
+            SRL::Types::Attribute::FaceVisibility::DoubleSided,
+            SRL::Types::Attribute::SortMode::Max,
+            No_Texture,
+            config.color,
+            CL32KRGB,
+            CL32KRGB | MESHon,
+            sprPolygon,
+            No_Option);
+        #pragma GCC diagnostic pop
+    }
+
+    /** @brief Desenha a sombra de um carro (matriz da camera no topo da pilha)
+     * @param position Posicao do carro no mundo
+     * @param yawDeg Rumo do carro em graus
+     * @return false fora da pista (sem chao sob o centro)
+     */
+    WORKRAM_HOT bool Draw(const TrackCollision& collision, const SRL::Math::Types::Vector3D& position, int32_t yawDeg)
+    {
+        using SRL::Math::Types::Fxp;
+        using SRL::Math::Types::Vector3D;
+
+        Fxp centerY;
+        if (!collision.GroundHeight(position, centerY)) return false;
+
+        // Cantos no espaco local (Z+ frente), girados como o carro
+        const Fxp localX[4] = {-config.halfWidth, config.halfWidth, config.halfWidth, -config.halfWidth};
+        const Fxp localZ[4] = {config.halfLength, config.halfLength, -config.halfLength, -config.halfLength};
+        for (size_t i = 0; i < 4; ++i)
+        {
+            Vector3D corner = Camera::CarToWorld(position, yawDeg, Vector3D(localX[i], Fxp::Convert(0), localZ[i]));
+            Fxp groundY = centerY;
+            collision.GroundHeight(corner, groundY);
+            corner.Y = groundY - config.lift;
+            quad.Vertices[i] = corner;
+        }
+
+        SRL::Scene3D::DrawMesh(quad);
+        return true;
+    }
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "camera_controller.hpp"
+#include "camera_rig.hpp"
+#include "track_collision.hpp"
+
+namespace Camera
+{
+enum class View : uint8_t
+{
+    Orbit,  // camera livre (UpdateInput)
+    Chase,  // atras do carro, com mola
+    Bumper, // para-choque
+    Hood,   // capo
+};
+
+struct ChaseTuning
+{
+    Fxp distance{Fxp(40.0f)};
+    int32_t pitchDeg{-12};
+    Fxp lookAhead{Fxp(60.0f)};
+    Fxp lookHeight{Fxp(-4.0f)};        // Y- acima
+    Fxp springRate{Fxp(0.12f)};        // omega * dt por tick; amortecimento critico, manter < 1
+    Fxp groundClearance{Fxp(2.0f)};
+    Vector3D bumperOffset{Vector3D(0.0f, -2.0f, 13.0f)}; // local do carro: Y- acima, Z+ frente
+    Vector3D hoodOffset{Vector3D(0.0f, -7.0f, 2.0f)};
+};
+
+// Estado de uma camera de perseguicao; cada jogador/replay tem a sua
+struct Chase
+{
+    View view = View::Orbit;
+    Vector3D position;
+    Vector3D velocity;
+    Vector3D lookAt;
+    bool settled = false;          // false = posiciona sem mola no proximo tick
+    CameraRig::Snapshot orbitSnap; // camera livre guardada ao sair do modo Orbit
+    OrbitCache behind;
+    OrbitCache ahead;
+};
+
+/** @brief Passa para a proxima vista (Orbit -> Chase -> Bumper -> Hood -> Orbit)
+ */
+inline void NextView(Chase& chase, State& state)
+{
+    if (chase.view == View::Orbit)
+    {
+        CameraRig::Save(state, chase.orbitSnap);
+    }
+
+    chase.view = (View)(((uint8_t)chase.view + 1) % 4);
+    chase.settled = false;
+
+    if (chase.view == View::Orbit)
+    {
+        CameraRig::Restore(state, chase.orbitSnap);
+    }
+}
+
+// Ponto no espaco local do carro (Y- acima, Z+ frente) levado ao mundo
+inline Vector3D CarToWorld(const Vector3D& carPosition, int32_t carYawDeg, const Vector3D& local)
+{
+    Fxp s = TrigTable::Sin(-carYawDeg);
+    Fxp c = TrigTable::Cos(-carYawDeg);
+    return carPosition + Vector3D(local.X * c + local.Z * s, local.Y, local.Z * c - local.X * s);
+}
+
+/** @brief Avanca a camera de perseguicao um tick e escreve a posicao em state
+ * @param collision Indice da pista (nullptr = sem colisao)
+ * @return Ponto para onde a camera olha
+ */
+inline Vector3D UpdateChase(Chase& chase, State& state, const ChaseTuning& tuning,
+                            const Vector3D& carPosition, int32_t carYawDeg, const TrackCollision* collision)
+{
+    // Ceu/chao seguem o carro: yaw da camera atras dele, olhar reto
+    state.yawDeg = TrigTable::Wrap(180 - carYawDeg);
+    state.viewYawDeg = 0;
+    state.viewPitchDeg = 0;
+    RefreshAngles(state);
+
+    Vector3D pivot = carPosition + Vector3D(Fxp::Convert(0), tuning.lookHeight, Fxp::Convert(0));
+    chase.lookAt = pivot + CachedOrbit(chase.ahead, -carYawDeg, 0, tuning.lookAhead);
+
+    if (chase.view == View::Bumper || chase.view == View::Hood)
+    {
+        const Vector3D& offset = chase.view == View::Bumper ? tuning.bumperOffset : tuning.hoodOffset;
+        chase.position = CarToWorld(carPosition, carYawDeg, offset);
+        chase.lookAt = chase.lookAt + Vector3D(Fxp::Convert(0), offset.Y - tuning.lookHeight, Fxp::Convert(0));
+        chase.velocity = Vector3D(Fxp::Convert(0), Fxp::Convert(0), Fxp::Convert(0));
+        state.location = chase.position;
+        return chase.lookAt;
+    }
+
+    Vector3D target = pivot + CachedOrbit(chase.behind, state.yawDeg, tuning.pitchDeg, tuning.distance);
+    if (!chase.settled)
+    {
+        chase.position = target;
+        chase.velocity = Vector3D(Fxp::Convert(0), Fxp::Convert(0), Fxp::Convert(0));
+        chase.settled = true;
+    }
+    else
+    {
+        // Mola criticamente amortecida: a = k^2 * erro - 2k * v (k = omega * dt)
+        Fxp k = tuning.springRate;
+        chase.velocity += (target - chase.position) * (k * k) - chase.velocity * (k + k);
+        chase.position += chase.velocity;
+    }
+
+    if (collision != nullptr)
+    {
+        // Nao atravessa muros entre o carro e a camera
+        Vector3D clamped = collision->ClampSegment(pivot, chase.position);
+        if (clamped.X.RawValue() != chase.position.X.RawValue() || clamped.Z.RawValue() != chase.position.Z.RawValue())
+        {
+            chase.position = clamped;
+            chase.velocity = Vector3D(Fxp::Convert(0), Fxp::Convert(0), Fxp::Convert(0));
+        }
+
+        // Nem desce abaixo do chao (Y+ para baixo)
+        Fxp groundY;
+        if (collision->GroundHeight(chase.position, groundY) && chase.position.Y > groundY - tuning.groundClearance)
+        {
+            chase.position.Y = groundY - tuning.groundClearance;
+            chase.velocity.Y = Fxp::Convert(0);
+        }
+    }
+
+    state.location = chase.position;
+    return chase.lookAt;
+}
+} // namespace Camera
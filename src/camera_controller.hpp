@@ -1,6 +1,8 @@
 #pragma once
 
 #include <srl.hpp>
+#include <climits>
+#include "trig_table.hpp"
 
 namespace Camera
 {
@@ -9,6 +11,26 @@ using SRL::Math::Types::Angle;
 using SRL::Math::Types::Vector3D;
 using SRL::Math::Types::Fxp;
 
+// Deslocamento de orbita ja calculado; refeito so quando yaw, pitch ou raio mudam
+struct OrbitCache
+{
+    int32_t yawDeg = INT32_MIN;
+    int32_t pitchDeg = INT32_MIN;
+    int32_t radiusRaw = 0;
+    Vector3D offset;
+};
+
+// Posicao de repouso da camera livre (restaurada ao soltar X)
+struct Home
+{
+    bool set = false;
+    int32_t yawDeg = 0;
+    int32_t pitchDeg = 0;
+    int32_t viewYawDeg = 0;
+    int32_t viewPitchDeg = 0;
+    Vector3D strafe;
+};
+
 struct State
 {
     int32_t yawDeg;
@@ -22,6 +44,11 @@ struct State
     Angle pitch;
     Angle viewYaw;
     Angle viewPitch;
+    int32_t angleDeg[4] = {INT32_MIN, INT32_MIN, INT32_MIN, INT32_MIN}; // graus de yaw/pitch/viewYaw/viewPitch ja convertidos
+    OrbitCache orbit;
+    OrbitCache view;
+    Home home;
+    bool wasXHeld = false;
 };
 
 struct Tuning
@@ -47,23 +74,47 @@ inline void Clamp(int32_t& v, int32_t min, int32_t max)
     if (v > max) v = max;
 }
 
-inline Vector3D OrbitPosition(Angle yaw, Angle pitch, Fxp radius)
+inline Vector3D OrbitPosition(int32_t yawDeg, int32_t pitchDeg, Fxp radius)
 {
-    Fxp sinYaw = SRL::Math::Trigonometry::Sin(yaw);
-    Fxp cosYaw = SRL::Math::Trigonometry::Cos(yaw);
-    Fxp sinPitch = SRL::Math::Trigonometry::Sin(pitch);
-    Fxp cosPitch = SRL::Math::Trigonometry::Cos(pitch);
+    Fxp sinYaw = TrigTable::Sin(yawDeg);
+    Fxp cosYaw = TrigTable::Cos(yawDeg);
+    Fxp sinPitch = TrigTable::Sin(pitchDeg);
+    Fxp cosPitch = TrigTable::Cos(pitchDeg);
     return Vector3D(radius * sinYaw * cosPitch,
                     radius * sinPitch,
                     radius * cosYaw * cosPitch);
 }
 
+inline const Vector3D& CachedOrbit(OrbitCache& cache, int32_t yawDeg, int32_t pitchDeg, Fxp radius)
+{
+    if (cache.yawDeg != yawDeg || cache.pitchDeg != pitchDeg || cache.radiusRaw != radius.RawValue())
+    {
+        cache.yawDeg = yawDeg;
+        cache.pitchDeg = pitchDeg;
+        cache.radiusRaw = radius.RawValue();
+        cache.offset = OrbitPosition(yawDeg, pitchDeg, radius);
+    }
+    return cache.offset;
+}
+
+inline void RefreshAngle(Angle& angle, int32_t& cachedDeg, int32_t deg)
+{
+    if (cachedDeg == deg) return;
+    cachedDeg = deg;
+    angle = Angle::FromDegrees(Fxp::Convert(deg));
+}
+
 inline void RefreshAngles(State& state)
 {
-    state.yaw = Angle::FromDegrees(Fxp::Convert(state.yawDeg));
-    state.pitch = Angle::FromDegrees(Fxp::Convert(state.pitchDeg));
-    state.viewYaw = Angle::FromDegrees(Fxp::Convert(state.viewYawDeg));
-    state.viewPitch = Angle::FromDegrees(Fxp::Convert(state.viewPitchDeg));
+    RefreshAngle(state.yaw, state.angleDeg[0], state.yawDeg);
+    RefreshAngle(state.pitch, state.angleDeg[1], state.pitchDeg);
+    RefreshAngle(state.viewYaw, state.angleDeg[2], state.viewYawDeg);
+    RefreshAngle(state.viewPitch, state.angleDeg[3], state.viewPitchDeg);
+}
+
+inline void RecalcPosition(State& state)
+{
+    state.location = CachedOrbit(state.orbit, state.yawDeg, state.pitchDeg, state.radius) + state.strafe;
 }
 
 inline void UpdateInput(State& state, const Tuning& tuning, Digital& pad)
@@ -73,19 +124,14 @@ inline void UpdateInput(State& state, const Tuning& tuning, Digital& pad)
     bool xHeld = pad.IsHeld(Digital::Button::X);
 
     // Salva posição inicial e restaura quando X não estiver pressionado
-    static bool homeSet = false;
-    static int32_t homeYawDeg = 0, homePitchDeg = 0, homeViewYawDeg = 0, homeViewPitchDeg = 0;
-    static Vector3D homeStrafe;
-    static bool wasXHeld = false;
-
-    if (!homeSet)
+    if (!state.home.set)
     {
-        homeYawDeg = state.yawDeg;
-        homePitchDeg = state.pitchDeg;
-        homeViewYawDeg = state.viewYawDeg;
-        homeViewPitchDeg = state.viewPitchDeg;
-        homeStrafe = state.strafe;
-        homeSet = true;
+        state.home.yawDeg = state.yawDeg;
+        state.home.pitchDeg = state.pitchDeg;
+        state.home.viewYawDeg = state.viewYawDeg;
+        state.home.viewPitchDeg = state.viewPitchDeg;
+        state.home.strafe = state.strafe;
+        state.home.set = true;
     }
 
     if (zHeld)
@@ -103,16 +149,16 @@ inline void UpdateInput(State& state, const Tuning& tuning, Digital& pad)
         if (pad.IsHeld(Digital::Button::Right)) state.yawDeg += tuning.yawStepDeg;
     }
     // Se X foi solto neste frame, restaurar posição inicial uma única vez
-    if (wasXHeld && !xHeld)
+    if (state.wasXHeld && !xHeld)
     {
-        state.yawDeg = homeYawDeg;
-        state.pitchDeg = homePitchDeg;
-        state.viewYawDeg = homeViewYawDeg;
-        state.viewPitchDeg = homeViewPitchDeg;
-        state.strafe = homeStrafe;
+        state.yawDeg = state.home.yawDeg;
+        state.pitchDeg = state.home.pitchDeg;
+        state.viewYawDeg = state.home.viewYawDeg;
+        state.viewPitchDeg = state.home.viewPitchDeg;
+        state.strafe = state.home.strafe;
     }
 
-    wasXHeld = xHeld;
+    state.wasXHeld = xHeld;
 
     if (yHeld)
     {
@@ -139,10 +185,10 @@ inline void UpdateInput(State& state, const Tuning& tuning, Digital& pad)
     Clamp(state.viewPitchDeg, tuning.viewPitchMinDeg, tuning.viewPitchMaxDeg);
 
     RefreshAngles(state);
-    state.location = OrbitPosition(state.yaw, state.pitch, state.radius) + state.strafe;
+    RecalcPosition(state);
 }
 
-inline Vector3D ComputeLookTarget(const State& state,
+inline Vector3D ComputeLookTarget(State& state,
                                   const Tuning& tuning,
                                   Digital& pad,
                                   const Vector3D& modelTarget = Vector3D(Fxp::Convert(0), Fxp::Convert(0), Fxp::Convert(0)))
@@ -151,6 +197,6 @@ inline Vector3D ComputeLookTarget(const State& state,
     {
         return modelTarget; // orbita olhando para o centro do modelo
     }
-    return state.strafe + OrbitPosition(state.viewYaw, state.viewPitch, tuning.targetDistance);
+    return state.strafe + CachedOrbit(state.view, state.viewYawDeg, state.viewPitchDeg, tuning.targetDistance);
 }
 } // namespace Camera
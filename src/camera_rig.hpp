@@ -81,6 +81,6 @@ namespace CameraRig
 
     inline void RecalcPosition(Camera::State& cam)
     {
-        cam.location = Camera::OrbitPosition(cam.yaw, cam.pitch, cam.radius) + cam.strafe;
+        Camera::RecalcPosition(cam);
     }
 } // namespace CameraRig
@@ -2,84 +2,118 @@
 
 #include <srl.hpp>
 #include "modelObject.hpp"
+#include "work_ram.hpp"
 #include <array>
 #include <vector>
 
 class CarRenderer
 {
 public:
+    static constexpr size_t WheelCount = 4;
+
+    // Roda: malha e ajuste do pivo em relacao ao centro da malha
+    struct WheelSpec
+    {
+        size_t meshId;
+        SRL::Math::Types::Vector3D pivotAdjust;
+    };
+
     struct Config
     {
         SRL::Math::Types::Vector3D modelCenter;
         SRL::Math::Types::Vector3D lightDirection;
         std::array<size_t, 5> drawOrder;
         size_t drawOrderCount;
+        // Rodas 3 e 4 giram em torno do centro deslocado de -32760 - 8 em Z (ajuste herdado do modelo)
+        std::array<WheelSpec, WheelCount> wheels = {{
+            {1, SRL::Math::Types::Vector3D(0.0f, 0.0f, 0.0f)},
+            {2, SRL::Math::Types::Vector3D(0.0f, 0.0f, 0.0f)},
+            {3, SRL::Math::Types::Vector3D(SRL::Math::Types::Fxp::Convert(0), SRL::Math::Types::Fxp::Convert(0), SRL::Math::Types::Fxp::Convert(-32768))},
+            {4, SRL::Math::Types::Vector3D(SRL::Math::Types::Fxp::Convert(0), SRL::Math::Types::Fxp::Convert(0), SRL::Math::Types::Fxp::Convert(-32768))},
+        }};
+        // Acima deste passo por frame a roda vira disco borrado; volta ao modelo abaixo de blurLeaveDeg
+        int32_t blurEnterDeg = 12;
+        int32_t blurLeaveDeg = 9;
+    };
+
+    static constexpr uint16_t BlurTextureSize = 32;
+
+    // No da hierarquia: matriz local refeita so quando o angulo muda
+    struct Node
+    {
+        size_t meshId = 0;
+        SRL::Math::Types::Vector3D pivot;
+        uint16_t angleRaw = 0;
+        bool dirty = true;
+        MATRIX local;
     };
 
     CarRenderer(ModelObject& car, bool isSmoothMesh, const Config& cfg)
         : car_(car), isSmooth_(isSmoothMesh), config_(cfg),
           rotY(SRL::Math::Types::Angle::FromDegrees(0)),
-          rotStep(SRL::Math::Types::Angle::FromDegrees(0.0f)),
-          wheel1Rot(SRL::Math::Types::Angle::FromDegrees(0)),
-          wheel1Step(SRL::Math::Types::Angle::FromDegrees(0)),
-          wheel2Rot(SRL::Math::Types::Angle::FromDegrees(0)),
-          wheel2Step(SRL::Math::Types::Angle::FromDegrees(0)),
-          wheel3Rot(SRL::Math::Types::Angle::FromDegrees(0)),
-          wheel3Step(SRL::Math::Types::Angle::FromDegrees(0)),
-          wheel4Rot(SRL::Math::Types::Angle::FromDegrees(0)),
-          wheel4Step(SRL::Math::Types::Angle::FromDegrees(0)),
-          wheel1StepSaved(SRL::Math::Types::Angle::FromDegrees(0)),
-          wheel2StepSaved(SRL::Math::Types::Angle::FromDegrees(0)),
-          wheel3StepSaved(SRL::Math::Types::Angle::FromDegrees(0)),
-          wheel4StepSaved(SRL::Math::Types::Angle::FromDegrees(0))
+          rotStep(SRL::Math::Types::Angle::FromDegrees(0.0f))
     {
+        for (size_t i = 0; i < WheelCount; ++i)
+        {
+            wheelRot_[i] = SRL::Math::Types::Angle::FromDegrees(0);
+            wheelStep_[i] = SRL::Math::Types::Angle::FromDegrees(0);
+            wheelStepSaved_[i] = SRL::Math::Types::Angle::FromDegrees(0);
+        }
+
         ComputeMeshCenters();
+        BuildNodes();
+        BuildBlurDiscs();
     }
 
-    void SetWheel1Step(const SRL::Math::Types::Angle& step) { wheel1Step = step; }
-    void ResetWheel1() { wheel1Rot = SRL::Math::Types::Angle::FromDegrees(0); }
+    void SetWheel1Step(const SRL::Math::Types::Angle& step) { wheelStep_[0] = step; }
+    void ResetWheel1() { wheelRot_[0] = SRL::Math::Types::Angle::FromDegrees(0); }
 
-    void SetWheel2Step(const SRL::Math::Types::Angle& step) { wheel2Step = step; }
-    void ResetWheel2() { wheel2Rot = SRL::Math::Types::Angle::FromDegrees(0); }
+    void SetWheel2Step(const SRL::Math::Types::Angle& step) { wheelStep_[1] = step; }
+    void ResetWheel2() { wheelRot_[1] = SRL::Math::Types::Angle::FromDegrees(0); }
 
-    void SetWheel3Step(const SRL::Math::Types::Angle& step) { wheel3Step = step; }
-    void ResetWheel3() { wheel3Rot = SRL::Math::Types::Angle::FromDegrees(0); }
+    void SetWheel3Step(const SRL::Math::Types::Angle& step) { wheelStep_[2] = step; }
+    void ResetWheel3() { wheelRot_[2] = SRL::Math::Types::Angle::FromDegrees(0); }
 
-    void SetWheel4Step(const SRL::Math::Types::Angle& step) { wheel4Step = step; }
-    void ResetWheel4() { wheel4Rot = SRL::Math::Types::Angle::FromDegrees(0); }
+    void SetWheel4Step(const SRL::Math::Types::Angle& step) { wheelStep_[3] = step; }
+    void ResetWheel4() { wheelRot_[3] = SRL::Math::Types::Angle::FromDegrees(0); }
 
     void ReverseAllWheels() {
-        wheel1Step = -wheel1Step; wheel2Step = -wheel2Step;
-        wheel3Step = -wheel3Step; wheel4Step = -wheel4Step;
+        for (auto& step : wheelStep_) step = -step;
     }
 
     void StartAllWheels(const SRL::Math::Types::Angle& step) {
-        wheel1Step = wheel2Step = wheel3Step = wheel4Step = step;
-        wheel1StepSaved = wheel2StepSaved = wheel3StepSaved = wheel4StepSaved = step;
+        for (size_t i = 0; i < WheelCount; ++i) wheelStep_[i] = wheelStepSaved_[i] = step;
     }
 
     void StopAllWheels() {
-        wheel1StepSaved = wheel1Step; wheel1Step = SRL::Math::Types::Angle::FromDegrees(0);
-        wheel2StepSaved = wheel2Step; wheel2Step = SRL::Math::Types::Angle::FromDegrees(0);
-        wheel3StepSaved = wheel3Step; wheel3Step = SRL::Math::Types::Angle::FromDegrees(0);
-        wheel4StepSaved = wheel4Step; wheel4Step = SRL::Math::Types::Angle::FromDegrees(0);
+        for (size_t i = 0; i < WheelCount; ++i)
+        {
+            wheelStepSaved_[i] = wheelStep_[i];
+            wheelStep_[i] = SRL::Math::Types::Angle::FromDegrees(0);
+        }
     }
 
     void ResumeAllWheels() {
-        if (wheel1Step.RawValue() == 0) wheel1Step = (wheel1StepSaved.RawValue()!=0 ? wheel1StepSaved : wheel1StepSavedDefault);
-        if (wheel2Step.RawValue() == 0) wheel2Step = (wheel2StepSaved.RawValue()!=0 ? wheel2StepSaved : wheel1StepSavedDefault);
-        if (wheel3Step.RawValue() == 0) wheel3Step = (wheel3StepSaved.RawValue()!=0 ? wheel3StepSaved : wheel1StepSavedDefault);
-        if (wheel4Step.RawValue() == 0) wheel4Step = (wheel4StepSaved.RawValue()!=0 ? wheel4StepSaved : wheel1StepSavedDefault);
+        for (size_t i = 0; i < WheelCount; ++i)
+        {
+            if (wheelStep_[i].RawValue() == 0) wheelStep_[i] = (wheelStepSaved_[i].RawValue() != 0 ? wheelStepSaved_[i] : wheelStepSavedDefault_);
+        }
     }
 
-    void Render()
+    WORKRAM_HOT void Render()
     {
-        SRL::Scene3D::PushMatrix();
-        // Move model center to origin and flip X
-        SRL::Math::Types::Vector3D modelOffset(-config_.modelCenter.X, -config_.modelCenter.Y, -config_.modelCenter.Z);
-        SRL::Scene3D::Translate(modelOffset);
-        SRL::Scene3D::RotateX(SRL::Math::Types::Angle::FromDegrees(180.0f));
-        SRL::Scene3D::RotateY(rotY);
+        // Corpo: mundo = camera * local (uma vez por frame); rodas partem da matriz do corpo
+        UpdateBodyNode();
+        for (size_t i = 0; i < WheelCount; ++i)
+        {
+            UpdateBlur(i);
+            if (!blurred_[i]) UpdateWheelNode(wheelNodes_[i], wheelRot_[i]);
+        }
+
+        MATRIX bodyWorld;
+        slPushMatrix();
+        slMultiMatrix(body_.local);
+        slGetMatrix(bodyWorld);
 
         for (size_t idx = 0; idx < config_.drawOrderCount; ++idx)
         {
@@ -89,73 +123,232 @@ public:
                 continue;
             }
 
-            SRL::Scene3D::PushMatrix();
-            // Roda_1 (mesh 1)
-            if (meshId == 1 && meshId < meshCenters_.size())
-            {
-                const auto& c = meshCenters_[meshId];
-                SRL::Scene3D::Translate(c);
-                SRL::Scene3D::RotateX(-wheel1Rot);
-                SRL::Scene3D::Translate(-c);
-            }
-            // Roda_2 (mesh 2)
-            if (meshId == 2 && meshId < meshCenters_.size())
-            {
-                const auto& c = meshCenters_[meshId];
-                SRL::Scene3D::Translate(c);
-                SRL::Scene3D::RotateX(-wheel2Rot);
-                SRL::Scene3D::Translate(-c);
-            }
-            // Roda_3 (mesh 3) piv? ajustado subtraindo 32760 e mais 8 no eixo Z
-            if (meshId == 3 && meshId < meshCenters_.size())
-            {
-                SRL::Math::Types::Vector3D c = meshCenters_[meshId];
-                c.Z = c.Z - SRL::Math::Types::Fxp::Convert(32760) - SRL::Math::Types::Fxp::Convert(8);
-                SRL::Scene3D::Translate(c);
-                SRL::Scene3D::RotateX(-wheel3Rot);
-                SRL::Scene3D::Translate(-c);
-            }
-            // Roda_4 (mesh 4) mesma l?gica de piv?
-            if (meshId == 4 && meshId < meshCenters_.size())
+            slLoadMatrix(bodyWorld);
+            Node* wheel = WheelNode(meshId);
+            if (wheel != nullptr && blurred_[wheel - wheelNodes_])
             {
-                SRL::Math::Types::Vector3D c = meshCenters_[meshId];
-                c.Z = c.Z - SRL::Math::Types::Fxp::Convert(32760) - SRL::Math::Types::Fxp::Convert(8);
-                SRL::Scene3D::Translate(c);
-                SRL::Scene3D::RotateX(-wheel4Rot);
-                SRL::Scene3D::Translate(-c);
+                SRL::Scene3D::DrawMesh(blurDiscs_[wheel - wheelNodes_]);
+                continue;
             }
+            if (wheel != nullptr) slMultiMatrix(wheel->local);
 
             if (isSmooth_)
                 car_.Draw(meshId, config_.lightDirection);
             else
                 car_.Draw(meshId);
-
-            SRL::Scene3D::PopMatrix();
         }
 
-        SRL::Scene3D::PopMatrix();
+        slPopMatrix();
+    }
+
+    /** @brief Mesma malha e matrizes de roda em outra posicao (outro carro)
+     * @note O no do corpo e refeito quando o giro muda entre chamadas
+     */
+    void RenderAt(const SRL::Math::Types::Vector3D& position, int32_t yawDeg)
+    {
+        rotY = SRL::Math::Types::Angle::FromDegrees(SRL::Math::Types::Fxp::Convert(yawDeg));
+        slPushMatrix();
+        slTranslate(position.X.RawValue(), position.Y.RawValue(), position.Z.RawValue());
+        Render();
+        slPopMatrix();
+    }
+
+    // Um tick de simulacao (60 Hz): giro do corpo e das rodas
+    void Advance()
+    {
         rotY += rotStep;
-        wheel1Rot -= wheel1Step;
-        wheel2Rot -= wheel2Step;
-        wheel3Rot -= wheel3Step;
-        wheel4Rot -= wheel4Step;
+        for (size_t i = 0; i < WheelCount; ++i) wheelRot_[i] -= wheelStep_[i];
     }
 
     SRL::Math::Types::Angle rotY;
     SRL::Math::Types::Angle rotStep;
     const std::vector<SRL::Math::Types::Vector3D>& MeshCenters() const { return meshCenters_; }
+    const SRL::Math::Types::Angle& WheelStep() const { return wheelStep_[0]; }
+    bool IsWheelBlurred(size_t wheel) const { return wheel < WheelCount && blurred_[wheel]; }
 
 private:
-    SRL::Math::Types::Angle wheel1Rot, wheel1Step;
-    SRL::Math::Types::Angle wheel2Rot, wheel2Step;
-    SRL::Math::Types::Angle wheel3Rot, wheel3Step;
-    SRL::Math::Types::Angle wheel4Rot, wheel4Step;
-    SRL::Math::Types::Angle wheel1StepSaved, wheel2StepSaved, wheel3StepSaved, wheel4StepSaved;
-    SRL::Math::Types::Angle wheel1StepSavedDefault = SRL::Math::Types::Angle::FromDegrees(SRL::Math::Types::Fxp::Convert(15));
+    SRL::Math::Types::Angle wheelRot_[WheelCount];
+    SRL::Math::Types::Angle wheelStep_[WheelCount];
+    SRL::Math::Types::Angle wheelStepSaved_[WheelCount];
+    SRL::Math::Types::Angle wheelStepSavedDefault_ = SRL::Math::Types::Angle::FromDegrees(SRL::Math::Types::Fxp::Convert(15));
+    Node body_;
+    Node wheelNodes_[WheelCount];
+    SRL::Types::Mesh blurDiscs_[WheelCount];
+    bool blurred_[WheelCount] = {};
+    int32_t blurTexture_ = -1;
+
+    // Pivos das rodas vem da configuracao + centro calculado da malha
+    void BuildNodes()
+    {
+        for (size_t i = 0; i < WheelCount; ++i)
+        {
+            Node& node = wheelNodes_[i];
+            node.meshId = config_.wheels[i].meshId;
+            node.pivot = (node.meshId < meshCenters_.size() ? meshCenters_[node.meshId] : SRL::Math::Types::Vector3D(0.0f, 0.0f, 0.0f)) + config_.wheels[i].pivotAdjust;
+            node.dirty = true;
+        }
+        body_.dirty = true;
+    }
+
+    Node* WheelNode(size_t meshId)
+    {
+        for (Node& node : wheelNodes_)
+        {
+            if (node.meshId == meshId && meshId < meshCenters_.size()) return &node;
+        }
+        return nullptr;
+    }
+
+    // Corpo: centro do modelo na origem, X invertido, giro em Y
+    void UpdateBodyNode()
+    {
+        if (!body_.dirty && body_.angleRaw == rotY.RawValue()) return;
+        body_.angleRaw = rotY.RawValue();
+        body_.dirty = false;
+
+        const auto& c = config_.modelCenter;
+        slPushMatrix();
+        slUnitMatrix(nullptr);
+        slTranslate(-c.X.RawValue(), -c.Y.RawValue(), -c.Z.RawValue());
+        slRotX(SRL::Math::Types::Angle::FromDegrees(180.0f).RawValue());
+        slRotY(rotY.RawValue());
+        slGetMatrix(body_.local);
+        slPopMatrix();
+    }
+
+    // Roda: giro em X em torno do pivo
+    void UpdateWheelNode(Node& node, const SRL::Math::Types::Angle& rot)
+    {
+        SRL::Math::Types::Angle angle = -rot;
+        if (!node.dirty && node.angleRaw == angle.RawValue()) return;
+        node.angleRaw = angle.RawValue();
+        node.dirty = false;
+
+        slPushMatrix();
+        slUnitMatrix(nullptr);
+        slTranslate(node.pivot.X.RawValue(), node.pivot.Y.RawValue(), node.pivot.Z.RawValue());
+        slRotX(angle.RawValue());
+        slTranslate(-node.pivot.X.RawValue(), -node.pivot.Y.RawValue(), -node.pivot.Z.RawValue());
+        slGetMatrix(node.local);
+        slPopMatrix();
+    }
+
+    // Histerese no passo da roda para nao alternar modelo/disco perto do limite
+    void UpdateBlur(size_t wheel)
+    {
+        if (blurTexture_ < 0)
+        {
+            blurred_[wheel] = false;
+            return;
+        }
+
+        int32_t step = (int16_t)wheelStep_[wheel].RawValue();
+        if (step < 0) step = -step;
+        int32_t limitDeg = blurred_[wheel] ? config_.blurLeaveDeg : config_.blurEnterDeg;
+        blurred_[wheel] = step > (int32_t)SRL::Math::Types::Angle::FromDegrees(SRL::Math::Types::Fxp::Convert(limitDeg)).RawValue();
+    }
+
+    // Textura do disco: pneu escuro e aro em gradiente radial (raios ja "borrados"); fora do circulo transparente
+    static int32_t LoadBlurTexture()
+    {
+        constexpr int32_t center = BlurTextureSize / 2;
+        uint16_t* pixels = new uint16_t[BlurTextureSize * BlurTextureSize];
+
+        for (int32_t y = 0; y < BlurTextureSize; ++y)
+        {
+            for (int32_t x = 0; x < BlurTextureSize; ++x)
+            {
+                int32_t dx = 2 * x + 1 - BlurTextureSize;
+                int32_t dy = 2 * y + 1 - BlurTextureSize;
+                int32_t d2 = (dx * dx + dy * dy) / 4; // distancia ao centro do pixel, ao quadrado
+                uint16_t shade = 0;
+
+                if (d2 < center * center)
+                {
+                    if (d2 >= 12 * 12) shade = 4;                              // pneu
+                    else if (d2 >= 6 * 6 && d2 < 8 * 8) shade = 12;            // faixa dos raios
+                    else shade = 22 - (uint16_t)((d2 * 10) / (12 * 12));      // aro, mais claro no cubo
+                }
+
+                pixels[y * BlurTextureSize + x] = shade == 0 ? 0 : (uint16_t)(0x8000 | (shade << 10) | (shade << 5) | shade);
+            }
+        }
+
+        int32_t index = SRL::VDP1::TryLoadTexture(BlurTextureSize, BlurTextureSize, SRL::CRAM::TextureColorMode::RGB555, 0, pixels);
+        delete[] pixels;
+        return index;
+    }
+
+    // Disco de cada roda: as duas faces laterais texturizadas e um corte transversal liso (visto de frente/tras),
+    // tudo no espaco da malha, desenhado so com a matriz do corpo
+    void BuildBlurDiscs()
+    {
+        blurTexture_ = LoadBlurTexture();
+        if (blurTexture_ < 0) return;
+
+        for (size_t i = 0; i < WheelCount; ++i)
+        {
+            size_t meshId = wheelNodes_[i].meshId;
+            if (meshId >= meshCenters_.size()) continue;
+
+            const auto& c = meshCenters_[meshId];
+            const auto& minV = meshMin_[meshId];
+            const auto& maxV = meshMax_[meshId];
+            SRL::Math::Types::Fxp halfY = (maxV.Y - minV.Y) / SRL::Math::Types::Fxp::Convert(2);
+            SRL::Math::Types::Fxp halfZ = (maxV.Z - minV.Z) / SRL::Math::Types::Fxp::Convert(2);
+            SRL::Math::Types::Fxp top = c.Y - halfY, bottom = c.Y + halfY;
+            SRL::Math::Types::Fxp back = c.Z - halfZ, front = c.Z + halfZ;
+
+            SRL::Types::Mesh disc(12, 3);
+            const SRL::Math::Types::Fxp sides[2] = {minV.X, maxV.X};
+            for (size_t side = 0; side < 2; ++side)
+            {
+                disc.Vertices[side * 4 + 0] = SRL::Math::Types::Vector3D(sides[side], top, back);
+                disc.Vertices[side * 4 + 1] = SRL::Math::Types::Vector3D(sides[side], top, front);
+                disc.Vertices[side * 4 + 2] = SRL::Math::Types::Vector3D(sides[side], bottom, front);
+                disc.Vertices[side * 4 + 3] = SRL::Math::Types::Vector3D(sides[side], bottom, back);
+            }
+            disc.Vertices[8] = SRL::Math::Types::Vector3D(minV.X, top, c.Z);
+            disc.Vertices[9] = SRL::Math::Types::Vector3D(maxV.X, top, c.Z);
+            disc.Vertices[10] = SRL::Math::Types::Vector3D(maxV.X, bottom, c.Z);
+            disc.Vertices[11] = SRL::Math::Types::Vector3D(minV.X, bottom, c.Z);
+
+            const SRL::Math::Types::Vector3D normals[3] = {
+                SRL::Math::Types::Vector3D(-1.0f, 0.0f, 0.0f),
+                SRL::Math::Types::Vector3D(1.0f, 0.0f, 0.0f),
+                SRL::Math::Types::Vector3D(0.0f, 0.0f, 1.0f),
+            };
+
+            for (size_t face = 0; face < 3; ++face)
+            {
+                disc.Faces[face].Normal = normals[face];
+                for (size_t v = 0; v < 4; ++v) disc.Faces[face].Vertices[v] = (uint16_t)(face * 4 + v);
+
+                bool textured = face < 2;
+                #pragma GCC diagnostic push
+                #pragma GCC diagnostic ignored "-Wnarrowing"
+                disc.Attributes[face] = SRL::Types::Attribute(
+                    SRL::Types::Attribute::FaceVisibility::DoubleSided,
+                    SRL::Types::Attribute::SortMode::Center,
+                    textured ? (uint16_t)blurTexture_ : No_Texture,
+                    textured ? No_Palet : C_RGB(4, 4, 4),
+                    CL32KRGB,
+                    CL32KRGB | MESHoff,
+                    textured ? sprNoflip : sprPolygon,
+                    No_Option);
+                #pragma GCC diagnostic pop
+            }
+
+            blurDiscs_[i] = std::move(disc);
+        }
+    }
+
     void ComputeMeshCenters()
     {
         size_t count = car_.GetMeshCount();
         meshCenters_.assign(count, SRL::Math::Types::Vector3D(0.0f, 0.0f, 0.0f));
+        meshMin_.assign(count, SRL::Math::Types::Vector3D(0.0f, 0.0f, 0.0f));
+        meshMax_.assign(count, SRL::Math::Types::Vector3D(0.0f, 0.0f, 0.0f));
 
         auto computeCenter = [&](auto* mesh, size_t idx)
         {
@@ -173,6 +366,8 @@ private:
                 maxV.Z = SRL::Math::Max(maxV.Z, p.Z);
             }
             meshCenters_[idx] = (minV + maxV) / SRL::Math::Types::Fxp::Convert(2);
+            meshMin_[idx] = minV;
+            meshMax_[idx] = maxV;
         };
 
         if (isSmooth_)
@@ -193,13 +388,19 @@ private:
 
     bool IsWheel(size_t meshId) const
     {
-        return meshId == 1 || meshId == 2 || meshId == 3 || meshId == 4;
+        for (const Node& node : wheelNodes_)
+        {
+            if (node.meshId == meshId) return true;
+        }
+        return false;
     }
 
     ModelObject& car_;
     bool isSmooth_;
     Config config_;
     std::vector<SRL::Math::Types::Vector3D> meshCenters_;
+    std::vector<SRL::Math::Types::Vector3D> meshMin_;
+    std::vector<SRL::Math::Types::Vector3D> meshMax_;
 };
 
 
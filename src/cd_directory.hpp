@@ -0,0 +1,295 @@
+#pragma once
+
+#include <srl.hpp>
+#include "work_ram.hpp"
+
+// Indice do diretorio do CD (ISO9660) lido uma unica vez no boot.
+// So substitui as sondagens: em vez de cada loader criar SRL::Cd::File e chamar Exists() em todos os
+// candidatos, depois de Init() Find/Resolve dizem em O(1) qual existe. A abertura continua por nome.
+// O GFS guarda so GFS_FNAME_LEN (12) caracteres do nome: nomes maiores do host passam pela tabela
+// DiscNames para o nome curto gravado no disco, e nomes que colidem no disco nao sao encontrados.
+namespace CdDirectory
+{
+    constexpr size_t MaxEntries = 768;     // raiz + ARQ_TGA (tga + xcf)
+    constexpr size_t TableSize = 1024;     // potencia de 2, > MaxEntries
+    constexpr size_t MaxDirs = 4;          // raiz + subdiretorios indexados
+    constexpr size_t NameLength = GFS_FNAME_LEN + 1;
+    constexpr uint16_t EmptySlot = 0xffff;
+
+    // Nome no host (como no repositorio) -> nome curto no disco
+    struct DiscName
+    {
+        const char* host;
+        const char* disc;
+    };
+
+    constexpr DiscName DiscNames[] = {
+        {"grama-verde-foto_64.tga", "gramav64.tga"},
+        {"grama_lateral_64.tga", "gramal64.tga"},
+    };
+
+    struct Entry
+    {
+        char name[NameLength]; // nome como gravado no disco (sem ";1")
+        uint8_t dir;           // 0 = raiz, >0 = indice em dirNames
+        int16_t fid;           // indice no diretorio lido (Init usa para achar os subdiretorios)
+        bool ambiguous;        // outro arquivo do diretorio tem o mesmo nome truncado
+    };
+
+    inline Entry entries[MaxEntries];
+    inline uint16_t table[TableSize];
+    inline char dirNames[MaxDirs][NameLength];
+    inline size_t entryCount = 0;
+    inline size_t dirCount = 0;
+    inline bool ready = false;
+
+    inline char Upper(char c)
+    {
+        return (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c;
+    }
+
+    // Compara nomes ignorando caixa e a versao ISO (";1")
+    inline bool NameEquals(const char* a, const char* b, size_t len)
+    {
+        for (size_t i = 0; i < len; ++i)
+        {
+            char ca = (a[i] == ';') ? '\0' : Upper(a[i]);
+            char cb = (b[i] == ';') ? '\0' : Upper(b[i]);
+            if (ca != cb) return false;
+            if (ca == '\0') return true;
+        }
+        return true;
+    }
+
+    // Tamanho ate o fim ou ate a versao ISO (";1")
+    inline size_t NameLengthOf(const char* name)
+    {
+        size_t n = 0;
+        while (name[n] != '\0' && name[n] != ';') ++n;
+        return n;
+    }
+
+    // FNV-1a sobre diretorio + nome normalizados
+    inline uint32_t Hash(uint8_t dir, const char* name, size_t len)
+    {
+        uint32_t h = 2166136261u ^ dir;
+        h *= 16777619u;
+        for (size_t i = 0; i < len && name[i] != '\0' && name[i] != ';'; ++i)
+        {
+            h ^= (uint8_t)Upper(name[i]);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    inline void Insert(uint8_t dir, int16_t fid, const GfsDirName& rec)
+    {
+        if (entryCount >= MaxEntries) return;
+
+        Entry& e = entries[entryCount];
+        size_t n = 0;
+        for (; n < GFS_FNAME_LEN && rec.fname[n] != '\0' && rec.fname[n] != ';'; ++n)
+        {
+            e.name[n] = rec.fname[n];
+        }
+        e.name[n] = '\0';
+        e.dir = dir;
+        e.fid = fid;
+        e.ambiguous = false;
+
+        uint32_t slot = Hash(dir, e.name, GFS_FNAME_LEN) & (TableSize - 1);
+        while (table[slot] != EmptySlot)
+        {
+            // Nomes longos que o GFS cortou no mesmo prefixo: nenhum dos dois e confiavel
+            Entry& other = entries[table[slot]];
+            if (other.dir == dir && NameEquals(other.name, e.name, GFS_FNAME_LEN))
+            {
+                other.ambiguous = true;
+                return;
+            }
+            slot = (slot + 1) & (TableSize - 1);
+        }
+        table[slot] = (uint16_t)entryCount++;
+    }
+
+    // Le um diretorio do disco (fid no diretorio corrente) e indexa suas entradas
+    inline int32_t LoadDir(int32_t fid, uint8_t dir, GfsDirName* scratch, size_t scratchCount)
+    {
+        GfsDirTbl dirTbl;
+        GFS_DIRTBL_TYPE(&dirTbl) = GFS_DIR_NAME;
+        GFS_DIRTBL_DIRNAME(&dirTbl) = scratch;
+        GFS_DIRTBL_NDIR(&dirTbl) = scratchCount;
+
+        int32_t count = GFS_LoadDir(fid, &dirTbl);
+        // 0 = ".", 1 = ".."
+        for (int32_t i = 2; i < count; ++i)
+        {
+            Insert(dir, (int16_t)i, scratch[i]);
+        }
+        return count;
+    }
+
+    /** @brief Le a raiz e os subdiretorios de primeiro nivel (ex.: ARQ_TGA) uma unica vez
+     * @return true se a raiz foi lida
+     */
+    inline bool Init()
+    {
+        if (ready) return true;
+
+        for (size_t i = 0; i < TableSize; ++i) table[i] = EmptySlot;
+        entryCount = 0;
+        dirNames[0][0] = '\0';
+        dirCount = 1;
+
+        // Buffer temporario apenas durante o boot
+        GfsDirName* scratch = (GfsDirName*)WorkRam::Allocate("cd dir", WorkRam::Region::Low, sizeof(GfsDirName) * MaxEntries);
+        if (scratch == nullptr) return false;
+        int32_t rootCount = LoadDir(0, 0, scratch, MaxEntries);
+        if (rootCount <= 0)
+        {
+            WorkRam::Free(scratch);
+            SRL::Debug::Print(1, 10, "CD dir read fail: %d", (int)rootCount);
+            return false;
+        }
+
+        // Copia os subdiretorios antes de reutilizar o scratch
+        size_t rootEntries = entryCount;
+        for (size_t i = 0; i < rootEntries && dirCount < MaxDirs; ++i)
+        {
+            if ((CDC_FILE_ATR(&scratch[entries[i].fid].dirrec) & CDC_ATR_DIRFG) == 0) continue;
+
+            uint8_t dir = (uint8_t)dirCount;
+            for (size_t c = 0; c < NameLength; ++c) dirNames[dir][c] = entries[i].name[c];
+            dirCount++;
+        }
+
+        for (uint8_t dir = 1; dir < dirCount; ++dir)
+        {
+            int32_t fid = GFS_NameToId((Sint8*)dirNames[dir]);
+            if (fid >= 0) LoadDir(fid, dir, scratch, MaxEntries);
+        }
+
+        WorkRam::Free(scratch);
+        ready = true;
+        return true;
+    }
+
+    /** @brief Busca uma entrada por caminho ("cd/data/ARQ_TGA/x.tga", "SKYBOX_1.TGA", ...)
+     * @note Prefixos do host (cd/, data/) sao ignorados; so o ultimo diretorio conta
+     * @return Entrada ou nullptr (tambem para nome maior que GFS_FNAME_LEN sem DiscNames ou ambiguo)
+     */
+    inline const Entry* Find(const char* path)
+    {
+        if (!ready || path == nullptr) return nullptr;
+
+        const char* name = path;
+        const char* parent = nullptr;
+        for (const char* p = path; *p != '\0'; ++p)
+        {
+            if (*p == '/' || *p == '\\')
+            {
+                parent = name;
+                name = p + 1;
+            }
+        }
+
+        uint8_t dir = 0;
+        if (parent != nullptr)
+        {
+            size_t parentLen = (size_t)(name - parent - 1);
+            for (uint8_t d = 1; d < dirCount; ++d)
+            {
+                if (parentLen < NameLength && dirNames[d][parentLen] == '\0' && NameEquals(dirNames[d], parent, parentLen))
+                {
+                    dir = d;
+                    break;
+                }
+            }
+        }
+
+        size_t nameLen = NameLengthOf(name);
+        for (const DiscName& alias : DiscNames)
+        {
+            if (NameLengthOf(alias.host) == nameLen && NameEquals(alias.host, name, nameLen))
+            {
+                name = alias.disc;
+                nameLen = NameLengthOf(name);
+                break;
+            }
+        }
+        if (nameLen > GFS_FNAME_LEN) return nullptr; // o disco so guarda o prefixo
+
+        uint32_t slot = Hash(dir, name, GFS_FNAME_LEN) & (TableSize - 1);
+        while (table[slot] != EmptySlot)
+        {
+            const Entry& e = entries[table[slot]];
+            if (e.dir == dir && NameEquals(e.name, name, GFS_FNAME_LEN))
+            {
+                return e.ambiguous ? nullptr : &e;
+            }
+            slot = (slot + 1) & (TableSize - 1);
+        }
+        return nullptr;
+    }
+
+    /** @brief Primeiro candidato presente no disco, sem tocar o CD
+     * @return Entrada ou nullptr
+     */
+    inline const Entry* Resolve(const char* const* paths, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Entry* e = Find(paths[i]);
+            if (e != nullptr) return e;
+        }
+        return nullptr;
+    }
+
+    /** @brief Caminho a ser aberto com SRL::Cd::File para o primeiro candidato existente
+     * @note Sem Init() (ou se a leitura falhou) volta a sondar com Exists()
+     * @note Na raiz devolve o nome do disco; em subdiretorio devolve o caminho recebido (quem precisar
+     * do diretorio corrente usa Resolve + ScopedDir, como o GroundPlane)
+     * @return Caminho ou nullptr se nenhum candidato existir
+     */
+    inline const char* ResolvePath(const char* const* paths, size_t count)
+    {
+        if (!ready)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                SRL::Cd::File probe(paths[i]);
+                if (probe.Exists()) return paths[i];
+            }
+            return nullptr;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Entry* e = Find(paths[i]);
+            if (e != nullptr) return e->dir == 0 ? e->name : paths[i];
+        }
+        return nullptr;
+    }
+
+    /** @brief Entra no subdiretorio de uma entrada (ARQ_TGA) enquanto o objeto existir
+     * @note Arquivos fora da raiz so podem ser abertos com o diretorio corrente certo
+     */
+    struct ScopedDir
+    {
+        bool changed = false;
+
+        explicit ScopedDir(const Entry* entry)
+        {
+            if (entry != nullptr && entry->dir != 0)
+            {
+                SRL::Cd::ChangeDir(dirNames[entry->dir]);
+                changed = true;
+            }
+        }
+
+        ~ScopedDir()
+        {
+            if (changed) SRL::Cd::ChangeDir((char*)nullptr);
+        }
+    };
+} // namespace CdDirectory
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <srl.hpp>
+
+// Neblina por distancia para a pista (depth cue). Entre fogStart e farClip o segmento troca a luz por
+// vertice por uma entrada fixa da tabela de gouraud; alem de farClip o segmento nem entra na lista.
+// O gouraud da VDP1 soma um deslocamento ao texel (nao mistura): sozinho, um texel branco no ultimo
+// nivel ainda sai perto de (15,15,31) com fundo azul. Por isso a segunda metade dos niveis liga tambem
+// a meia luminancia, que divide o texel por 2 antes do deslocamento: no nivel Levels/2 o resultado e a
+// media exata texel/fundo, e no ultimo nivel sobra no maximo meio texel (8 de 31) de diferenca.
+// O corte no farClip fica bem mais suave, mas nao some.
+struct DepthFog
+{
+    static constexpr uint8_t Levels = 8;
+    static constexpr uint8_t Clipped = Levels + 1;
+    static constexpr uint16_t GouraudBase = 0xe000; // mesma base do ModelObject
+    static constexpr int32_t Neutral = 16;          // gouraud sem alteracao na cor do texel
+    static constexpr uint8_t HalfFrom = Levels / 2; // primeiro nivel com meia luminancia
+
+    struct Config
+    {
+        int32_t fogStart = 320; // unidades do mundo (segmento tipico ~23)
+        int32_t farClip = 640;
+    };
+
+    Config config;
+    int32_t limit2[Levels + 1] = {}; // distancia^2 do inicio de cada nivel; [Levels] = farClip
+    uint16_t firstEntry = 0;         // entrada da tabela de gouraud do nivel 1
+    bool enabled = false;
+
+    /** @brief Escreve os niveis na tabela de trabalho do gouraud (copiada para a VDP1 no vblank)
+     * @param table Tabela de trabalho, 4 cores por entrada
+     * @param entry Primeira entrada livre, depois das faces
+     * @param color Cor de fundo em RGB555 (0-31 por canal)
+     */
+    void Init(SRL::Types::HighColor* table, uint16_t entry, const uint8_t* color)
+    {
+        firstEntry = entry;
+        for (uint8_t level = 1; level <= Levels; ++level)
+        {
+            // Alvo: texel * (1 - t) + fundo * t, acertado para o texel medio (16)
+            int32_t rgb[3];
+            for (size_t c = 0; c < 3; ++c)
+            {
+                int32_t target = (Neutral * (Levels - level) + (int32_t)color[c] * level) / Levels;
+                int32_t texel = level >= HalfFrom ? Neutral / 2 : Neutral;
+                int32_t value = target - texel + Neutral;
+                rgb[c] = value < 0 ? 0 : (value > 31 ? 31 : value);
+            }
+
+            for (size_t corner = 0; corner < 4; ++corner)
+            {
+                table[(entry + level - 1) * 4 + corner] = SRL::Types::HighColor::FromRGB555(rgb[0], rgb[1], rgb[2]);
+            }
+        }
+
+        SetRange(config.fogStart, config.farClip);
+        enabled = true;
+    }
+
+    // Distancias dos niveis; as cores ja escritas na tabela nao mudam
+    void SetRange(int32_t fogStart, int32_t farClip)
+    {
+        config.fogStart = fogStart;
+        config.farClip = farClip;
+        int32_t span = farClip - fogStart;
+        for (uint8_t level = 0; level <= Levels; ++level)
+        {
+            int32_t distance = fogStart + span * level / Levels;
+            limit2[level] = distance * distance;
+        }
+    }
+
+    /** @brief Nivel de neblina de um ponto a (dx, dz) do olho
+     * @return 0 sem neblina, 1..Levels, ou Clipped alem do farClip
+     */
+    uint8_t Level(int32_t dx, int32_t dz) const
+    {
+        if (!enabled) return 0;
+        if (dx < -config.farClip || dx > config.farClip || dz < -config.farClip || dz > config.farClip) return Clipped;
+
+        int32_t distance2 = dx * dx + dz * dz;
+        for (uint8_t level = 0; level <= Levels; ++level)
+        {
+            if (distance2 < limit2[level]) return level;
+        }
+        return Clipped;
+    }
+
+    // Nivel que tambem usa meia luminancia (CL_Half)
+    bool Half(uint8_t level) const
+    {
+        return level >= HalfFrom && level <= Levels;
+    }
+
+    // gstb do nivel (0 = luz normal)
+    uint16_t Entry(uint8_t level) const
+    {
+        return level == 0 || level > Levels ? 0 : GouraudBase + firstEntry + level - 1;
+    }
+};
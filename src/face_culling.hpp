@@ -0,0 +1,482 @@
+#pragma once
+
+#include <srl.hpp>
+#include <vector>
+#include "modelObject.hpp"
+#include "near_subdivision.hpp"
+#include "scratchpad.hpp"
+#include "work_ram.hpp"
+
+// Pre-passe de backface no espaco do modelo, antes do SGL: faces de um lado so sao testadas pelo plano
+// (normal do arquivo) contra a posicao do olho. Faces com normais parecidas formam um cone por malha,
+// e um cone inteiro de costas e descartado com um teste so. O que sobra vira uma lista compacta de
+// vertices/poligonos por frame, entao o SGL so transforma o que pode aparecer.
+// A marcacao roda no SH-2 escravo (Kick/Wait) enquanto o mestre segue com o frame.
+struct FaceCulling
+{
+    static constexpr uint16_t MaxClusterFaces = 32;
+    static constexpr int32_t ClusterCos = 0xb505; // cos 45 graus: abertura maxima do cone em relacao a semente
+    static constexpr uint16_t NoVertex = 0xffff;
+
+    // Cone de normais: eixo, meia abertura (como corda |n - eixo|) e esfera com as faces (raio L1)
+    struct Cluster
+    {
+        int32_t axis[3];
+        int32_t center[3];
+        int32_t chord;
+        int32_t radius;
+        uint16_t first; // em faceOrder da malha
+        uint16_t count;
+    };
+
+    // O que o Mark le, em registros de 16/32 bytes (1-2 linhas do cache do SH-2) e na ordem em que sao
+    // percorridos: o laco anda em memoria contigua e nao toca os POLYGON da malha
+    struct Cone
+    {
+        int32_t axis[3];
+        int32_t chord;
+        int32_t center[3];
+        int32_t radius;
+    };
+
+    struct Plane
+    {
+        int32_t normal[3];
+        int32_t w; // dot(normal, vertice 0)
+    };
+
+    struct MeshInfo
+    {
+        uint32_t firstFace;    // em planes/faceOrder
+        uint32_t firstMark;    // em visible, multiplo de 4
+        uint16_t firstCluster;
+        uint16_t clusterCount;
+    };
+
+    // Pedido para o escravo; ele le tudo pelo endereco sem cache
+    struct Job
+    {
+        int32_t eye[3];
+        const uint16_t* meshList;
+        uint16_t meshCount;
+        bool onSlave;
+        volatile bool done;
+    };
+
+    std::vector<MeshInfo> meshes;
+    std::vector<Cone> cones;
+    std::vector<uint32_t> coneRanges; // first | count << 16, separado do Cone para caber em 32 bytes
+    std::vector<Plane> planes;        // na ordem de faceOrder
+    std::vector<uint16_t> faceOrder;  // faces agrupadas por cone; faces de dois lados no fim, sem cone
+    std::vector<uint8_t> visible;     // marca por face, todas as malhas (escrito pelo escravo)
+    std::vector<uint16_t> remap;      // vertice da malha -> vertice compacto (maior malha)
+    Job job = {};
+    bool useSlave = false;
+
+    // Lista compacta do frame: reaproveitada a cada Synchronize
+    std::vector<SRL::Math::Types::Vector3D> points;  // mesmo layout de POINT/VECTOR
+    std::vector<SRL::Math::Types::Vector3D> normals;
+    std::vector<POLYGON> polygons;
+    std::vector<ATTR> attributes;
+    uint32_t pointCount = 0;
+    uint32_t polygonCount = 0;
+    uint32_t culledFaces = 0;
+    bool ready = false;
+
+    static int32_t Mul(int32_t a, int32_t b)
+    {
+        return (int32_t)(((int64_t)a * b) >> 16);
+    }
+
+    static int32_t Dot(const int32_t* a, const int32_t* b)
+    {
+        return (int32_t)(((int64_t)a[0] * b[0] + (int64_t)a[1] * b[1] + (int64_t)a[2] * b[2]) >> 16);
+    }
+
+    static int32_t Abs(int32_t value)
+    {
+        return value < 0 ? -value : value;
+    }
+
+    // Raiz de 16.16 em 16.16 (so no load)
+    static int32_t Sqrt(int32_t value)
+    {
+        uint64_t x = (uint64_t)value << 16;
+        uint64_t result = 0;
+        for (uint64_t bit = 1ull << 46; bit != 0; bit >>= 2)
+        {
+            if (x >= result + bit)
+            {
+                x -= result + bit;
+                result = (result >> 1) + bit;
+            }
+            else
+            {
+                result >>= 1;
+            }
+        }
+        return (int32_t)result;
+    }
+
+    static void Raw(const SRL::Math::Types::Vector3D& v, int32_t* out)
+    {
+        out[0] = v.X.RawValue();
+        out[1] = v.Y.RawValue();
+        out[2] = v.Z.RawValue();
+    }
+
+    /** @brief Monta planos e cones de todas as malhas (uma vez, no load)
+     * @param model Modelo smooth (pista)
+     */
+    WORKRAM_COLD bool Build(ModelObject& model)
+    {
+        ready = false;
+        if (!model.IsSmooth()) return false;
+
+        size_t meshCount = model.GetMeshCount();
+        meshes.assign(meshCount, MeshInfo{});
+        planes.assign(model.GetFaceCount(), Plane{});
+        faceOrder.assign(model.GetFaceCount(), 0);
+        std::vector<Cluster> clusters;
+
+        size_t maxVertices = 0;
+        uint32_t faceBase = 0, markBase = 0;
+        for (size_t m = 0; m < meshCount; ++m)
+        {
+            auto* mesh = model.GetMesh<SRL::Types::SmoothMesh>(m);
+            if (mesh->VertexCount > maxVertices) maxVertices = mesh->VertexCount;
+
+            meshes[m].firstFace = faceBase;
+            meshes[m].firstMark = markBase;
+            BuildClusters(*mesh, meshes[m], clusters);
+            faceBase += mesh->FaceCount;
+            markBase += (mesh->FaceCount + 3) & ~3u;
+        }
+
+        cones.resize(clusters.size());
+        coneRanges.resize(clusters.size());
+        for (size_t c = 0; c < clusters.size(); ++c)
+        {
+            const Cluster& cluster = clusters[c];
+            Cone& cone = cones[c];
+            for (size_t k = 0; k < 3; ++k)
+            {
+                cone.axis[k] = cluster.axis[k];
+                cone.center[k] = cluster.center[k];
+            }
+            cone.chord = cluster.chord;
+            cone.radius = cluster.radius;
+            coneRanges[c] = cluster.first | ((uint32_t)cluster.count << 16);
+        }
+
+        visible.assign(markBase, 0);
+        remap.assign(maxVertices, NoVertex);
+        points.resize(model.GetVertexCount() + NearSubdivision::MaxExtraVertices);
+        normals.resize(model.GetVertexCount() + NearSubdivision::MaxExtraVertices);
+        polygons.resize(model.GetFaceCount() + NearSubdivision::MaxExtraFaces);
+        attributes.resize(model.GetFaceCount() + NearSubdivision::MaxExtraFaces);
+        ready = true;
+        return true;
+    }
+
+    void BuildClusters(const SRL::Types::SmoothMesh& mesh, MeshInfo& info, std::vector<Cluster>& clusters)
+    {
+        info.firstCluster = (uint16_t)clusters.size();
+        size_t faceCount = mesh.FaceCount;
+        std::vector<uint16_t> clusterOf(faceCount, 0xffff);
+
+        // Semente = primeira face que nao coube nos cones ja abertos
+        for (size_t f = 0; f < faceCount; ++f)
+        {
+            int32_t normal[3];
+            Raw(mesh.Faces[f].Normal, normal);
+            if (((const ATTR*)&mesh.Attributes[f])->flag != Single_Plane) continue;
+
+            for (uint16_t c = info.firstCluster; c < clusters.size(); ++c)
+            {
+                if (clusters[c].count < MaxClusterFaces && Dot(clusters[c].axis, normal) >= ClusterCos)
+                {
+                    clusterOf[f] = c;
+                    clusters[c].count++;
+                    break;
+                }
+            }
+
+            if (clusterOf[f] == 0xffff)
+            {
+                Cluster cluster{};
+                for (size_t i = 0; i < 3; ++i) cluster.axis[i] = normal[i];
+                cluster.count = 1;
+                clusterOf[f] = (uint16_t)clusters.size();
+                clusters.push_back(cluster);
+            }
+        }
+        info.clusterCount = (uint16_t)(clusters.size() - info.firstCluster);
+
+        // Faces contiguas por cone (contagem), as de dois lados por ultimo
+        uint16_t offset = 0;
+        for (uint16_t c = info.firstCluster; c < clusters.size(); ++c)
+        {
+            clusters[c].first = offset;
+            offset += clusters[c].count;
+            clusters[c].count = 0;
+        }
+        uint16_t doubleSided = offset;
+        for (size_t f = 0; f < faceCount; ++f)
+        {
+            uint16_t slot = clusterOf[f] == 0xffff ? doubleSided++ : clusters[clusterOf[f]].first + clusters[clusterOf[f]].count++;
+            faceOrder[info.firstFace + slot] = (uint16_t)f;
+
+            Plane& plane = planes[info.firstFace + slot];
+            int32_t vertex[3];
+            Raw(mesh.Faces[f].Normal, plane.normal);
+            Raw(mesh.Vertices[mesh.Faces[f].Vertices[0]], vertex);
+            plane.w = Dot(plane.normal, vertex);
+        }
+
+        for (uint16_t c = info.firstCluster; c < clusters.size(); ++c) BoundCluster(mesh, info, clusters[c]);
+    }
+
+    // Abertura do cone e esfera que contem todas as faces do cone
+    void BoundCluster(const SRL::Types::SmoothMesh& mesh, const MeshInfo& info, Cluster& cluster)
+    {
+        int32_t minCos = 0x10000;
+        int32_t minV[3] = {INT32_MAX, INT32_MAX, INT32_MAX};
+        int32_t maxV[3] = {INT32_MIN, INT32_MIN, INT32_MIN};
+        for (uint16_t i = 0; i < cluster.count; ++i)
+        {
+            const auto& face = mesh.Faces[faceOrder[info.firstFace + cluster.first + i]];
+            int32_t normal[3];
+            Raw(face.Normal, normal);
+            int32_t cosine = Dot(cluster.axis, normal);
+            if (cosine < minCos) minCos = cosine;
+
+            for (size_t v = 0; v < 4; ++v)
+            {
+                int32_t p[3];
+                Raw(mesh.Vertices[face.Vertices[v]], p);
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    if (p[k] < minV[k]) minV[k] = p[k];
+                    if (p[k] > maxV[k]) maxV[k] = p[k];
+                }
+            }
+        }
+
+        for (size_t k = 0; k < 3; ++k) cluster.center[k] = minV[k] + (maxV[k] - minV[k]) / 2;
+        cluster.radius = (maxV[0] - minV[0]) / 2 + (maxV[1] - minV[1]) / 2 + (maxV[2] - minV[2]) / 2;
+        cluster.chord = Sqrt(2 * (0x10000 - (minCos < -0x10000 ? -0x10000 : minCos)));
+    }
+
+    /** @brief Marca as faces da malha que podem estar de frente para o olho
+     * @param eye Olho no espaco do modelo
+     * @param marks Saida, uma marca por face da malha
+     */
+    WORKRAM_HOT void Mark(size_t meshId, const int32_t* eye, uint8_t* marks, uint16_t faceCount) const
+    {
+        const MeshInfo& info = meshes[meshId];
+        const uint16_t* order = &faceOrder[info.firstFace];
+        const Plane* plane = &planes[info.firstFace];
+        for (uint16_t f = 0; f < faceCount; ++f) marks[f] = 0;
+
+        uint16_t singleSided = 0;
+        for (uint16_t c = 0; c < info.clusterCount; ++c)
+        {
+            const Cone& cone = cones[info.firstCluster + c];
+            uint32_t range = coneRanges[info.firstCluster + c];
+            uint16_t first = (uint16_t)range;
+            uint16_t count = (uint16_t)(range >> 16);
+            singleSided += count;
+
+            // Para toda normal n do cone e ponto p da esfera: dot(n, olho - p) <= dot(eixo, d) + corda * |d| + raio
+            int32_t d[3] = {eye[0] - cone.center[0], eye[1] - cone.center[1], eye[2] - cone.center[2]};
+            int32_t reach = Dot(cone.axis, d) + Mul(cone.chord, Abs(d[0]) + Abs(d[1]) + Abs(d[2])) + cone.radius;
+            if (reach < 0) continue;
+
+            for (uint16_t i = first; i < first + count; ++i)
+            {
+                if (Dot(plane[i].normal, eye) - plane[i].w >= 0) marks[order[i]] = 1;
+            }
+        }
+
+        for (uint16_t i = singleSided; i < faceCount; ++i) marks[order[i]] = 1;
+    }
+
+    // Marca todas as malhas do job; no escravo as marcas de cada malha saem da RAM interna em palavras.
+    // Cones, faixas, planos e faceOrder sao lidos uma vez por frame e em ordem: passam pelos 2 KB de cache
+    // que sobram sem precisar de copia; so as marcas, escritas fora de ordem, ficam na RAM interna
+    WORKRAM_HOT void RunJob(const Job& request, ModelObject& model)
+    {
+        for (uint16_t i = 0; i < request.meshCount; ++i)
+        {
+            uint16_t meshId = request.meshList[i];
+            uint16_t faceCount = model.GetMesh<SRL::Types::SmoothMesh>(meshId)->FaceCount;
+            uint8_t* out = &visible[meshes[meshId].firstMark];
+            if (!request.onSlave)
+            {
+                Mark(meshId, request.eye, out, faceCount);
+                continue;
+            }
+
+            Scratchpad::Reset();
+            uint8_t* marks = Scratchpad::Take<uint8_t>(faceCount);
+            if (marks == nullptr)
+            {
+                Mark(meshId, request.eye, out, faceCount);
+                continue;
+            }
+
+            Mark(meshId, request.eye, marks, faceCount);
+            uint32_t* words = (uint32_t*)out;
+            const uint32_t* source = (const uint32_t*)marks;
+            for (uint16_t w = 0; w < (faceCount + 3) / 4; ++w) words[w] = source[w];
+        }
+    }
+
+    struct SlaveArgs
+    {
+        FaceCulling* self;
+        ModelObject* model;
+    };
+
+    // Roda no SH-2 escravo: copia o pedido (sem cache) e marca
+    static void RunOnSlave(void* arg)
+    {
+        SlaveArgs* args = Scratchpad::Uncached((SlaveArgs*)arg);
+        FaceCulling* self = args->self;
+        Scratchpad::PurgeOnSlave();
+
+        const Job& shared = *Scratchpad::Uncached(&self->job);
+        Job request = {{shared.eye[0], shared.eye[1], shared.eye[2]}, shared.meshList, shared.meshCount, true, false};
+        self->RunJob(request, *args->model);
+        Scratchpad::Uncached(&self->job)->done = true;
+    }
+
+    SlaveArgs slaveArgs = {};
+
+    /** @brief Comeca a marcar as malhas da lista; no escravo quando useSlave e a RAM interna estiver ligada
+     * @param list Malhas do frame (precisa ficar intacta ate Wait)
+     * @param eye Olho no espaco do modelo
+     */
+    WORKRAM_HOT void Kick(ModelObject& model, const uint16_t* list, uint16_t count, const int32_t* eye)
+    {
+        if (!ready) return;
+
+        bool onSlave = useSlave && *Scratchpad::Uncached(&Scratchpad::slaveReady);
+        job = Job{{eye[0], eye[1], eye[2]}, list, count, onSlave, false};
+        if (!onSlave)
+        {
+            RunJob(job, model);
+            job.done = true;
+            return;
+        }
+
+        slaveArgs = SlaveArgs{this, &model};
+        slSlaveFunc(RunOnSlave, &slaveArgs);
+    }
+
+    // Espera o escravo terminar as marcas do frame
+    WORKRAM_HOT void Wait()
+    {
+        while (!*Scratchpad::Uncached(&job.done))
+        {
+        }
+    }
+
+    void BeginFrame()
+    {
+        pointCount = 0;
+        polygonCount = 0;
+        culledFaces = 0;
+    }
+
+    /** @brief Desenha a malha a partir da lista compacta das faces marcadas (ordem original preservada)
+     * @note Depois de Wait
+     * @param light Direcao da luz
+     * @param fogEntry gstb fixo de neblina para as faces com gouraud (0 = luz por vertice)
+     * @param near Divisao/corte das faces perto do olho (nullptr em segmentos distantes)
+     * @param fogHalf Nivel de neblina que tambem liga a meia luminancia (DepthFog::Half)
+     */
+    WORKRAM_HOT void Draw(ModelObject& model, size_t meshId, SRL::Math::Types::Vector3D& light, uint16_t fogEntry = 0, NearSubdivision* near = nullptr, bool fogHalf = false)
+    {
+        auto* mesh = model.GetMesh<SRL::Types::SmoothMesh>(meshId);
+        if (!ready) return;
+
+        // Escrito pelo escravo em palavras: lido sem cache (para nao pegar linhas do frame anterior) e
+        // tambem em palavras, 4 marcas por acesso ao barramento; grupo de 4 faces sem marca sai de uma vez
+        const uint32_t* marks = Scratchpad::Uncached((const uint32_t*)&visible[meshes[meshId].firstMark]);
+        uint32_t word = 0;
+        SRL::Math::Types::Vector3D* meshPoints = &points[pointCount];
+        SRL::Math::Types::Vector3D* meshNormals = &normals[pointCount];
+        POLYGON* meshPolygons = &polygons[polygonCount];
+        ATTR* meshAttributes = &attributes[polygonCount];
+        uint32_t vertexUsed = 0, faceUsed = 0, marked = 0;
+
+        for (size_t v = 0; v < mesh->VertexCount; ++v) remap[v] = NoVertex;
+
+        for (size_t f = 0; f < mesh->FaceCount; ++f)
+        {
+            if ((f & 3) == 0)
+            {
+                word = marks[f >> 2];
+                if (word == 0)
+                {
+                    f += 3;
+                    continue;
+                }
+            }
+
+            // SH-2 big-endian: a marca da face 4k fica no byte alto
+            if (((word >> (24 - 8 * (f & 3))) & 0xff) == 0) continue;
+            ++marked;
+
+            if (near != nullptr)
+            {
+                NearSubdivision::Output out = {meshPoints, meshNormals, meshPolygons, meshAttributes, vertexUsed, faceUsed};
+                if (near->Emit(*mesh, f, out))
+                {
+                    vertexUsed = out.vertexCount;
+                    faceUsed = out.faceCount;
+                    continue;
+                }
+            }
+
+            const auto& face = mesh->Faces[f];
+            POLYGON& out = meshPolygons[faceUsed];
+            out = *(const POLYGON*)&face;
+            for (size_t i = 0; i < 4; ++i)
+            {
+                uint16_t v = face.Vertices[i];
+                if (remap[v] == NoVertex)
+                {
+                    remap[v] = (uint16_t)vertexUsed;
+                    meshPoints[vertexUsed] = mesh->Vertices[v];
+                    meshNormals[vertexUsed] = mesh->Normals[v];
+                    ++vertexUsed;
+                }
+                out.Vertices[i] = remap[v];
+            }
+            ATTR& attribute = meshAttributes[faceUsed];
+            attribute = *(const ATTR*)&mesh->Attributes[f];
+            if (fogEntry != 0 && (attribute.sort & UseGouraud))
+            {
+                // Sem UseGouraud o SGL nao recalcula a entrada; a VDP1 le a cor fixa do nivel
+                attribute.sort &= ~UseGouraud;
+                attribute.gstb = fogEntry;
+
+                // Faces com transparencia ja usam o modo de calculo de cor
+                if (fogHalf && (attribute.atrb & CL_Trans) == 0) attribute.atrb |= CL_Half;
+            }
+            ++faceUsed;
+        }
+
+        culledFaces += mesh->FaceCount - marked;
+        if (faceUsed == 0) return;
+
+        XPDATA compact = {(POINT*)meshPoints, vertexUsed, meshPolygons, faceUsed, meshAttributes, (VECTOR*)meshNormals};
+        slPutPolygonX(&compact, (FIXED*)&light);
+
+        pointCount += vertexUsed;
+        polygonCount += faceUsed;
+    }
+};
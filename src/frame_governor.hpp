@@ -0,0 +1,127 @@
+#pragma once
+
+#include <srl.hpp>
+
+// Ritmo de frames em tempo de execucao. O custo de CPU de cada frame (do inicio do laco ate o Synchronize)
+// vem do FRT do mestre; frames que levaram mais campos do que o previsto indicam VDP1 atrasada. Com carga
+// alta o governador primeiro sobe o vies de detalhe (janela e neblina mais curtas, sem divisao perto da
+// camera) e so no vies maximo cai para 30 Hz; volta a 60 Hz com folga e depois de um tempo (histerese).
+// A simulacao anda em ticks fixos de 60 Hz: a cada frame roda tantos ticks quantos campos passaram.
+struct FrameGovernor
+{
+    static constexpr uint8_t MaxBias = 3;
+    static constexpr uint8_t MaxTicks = 4; // alcance depois de um engasgo (carga de CD, troca de ceu)
+
+    // FRT do mestre (o escravo usa o dele para o slSlaveFunc)
+    static constexpr uintptr_t FrcHigh = 0xfffffe12;
+    static constexpr uintptr_t FrcLow = 0xfffffe13;
+    static constexpr uintptr_t TimerControl = 0xfffffe16; // TCR
+    static constexpr uint8_t ClockDiv128 = 2;             // CKS: phi/128, ~210 kHz no modo 320
+
+    struct Config
+    {
+        uint16_t fieldTicks = 3500;  // um campo NTSC em ticks do FRT (phi/128 a 26,8 MHz)
+        uint8_t raiseLoad = 88;      // % de um campo: acima disso sobe o vies
+        uint8_t lowerLoad = 60;      // abaixo disso desce o vies
+        uint8_t recoverLoad = 70;    // em 30 Hz com vies maximo: abaixo disso volta a 60 Hz
+        uint8_t raiseFrames = 6;
+        uint8_t lowerFrames = 90;
+        uint8_t recoverFrames = 120;
+    };
+
+    Config config;
+    uint16_t frameStart = 0;
+    uint16_t load = 0;  // media movel do custo, % de um campo de 60 Hz
+    uint8_t rate = 1;   // campos por frame (1 = 60 Hz, 2 = 30 Hz)
+    uint8_t bias = 0;   // 0 = detalhe completo .. MaxBias
+    uint8_t fields = 1; // campos do ultimo frame
+    uint8_t over = 0;
+    uint8_t under = 0;
+
+    static uint16_t Now()
+    {
+        uint8_t high = *(volatile uint8_t*)FrcHigh; // ler o alto primeiro trava o baixo
+        return (uint16_t)(high << 8 | *(volatile uint8_t*)FrcLow);
+    }
+
+    void Init()
+    {
+        volatile uint8_t* tcr = (volatile uint8_t*)TimerControl;
+        *tcr = (uint8_t)((*tcr & ~3) | ClockDiv128);
+        SynchConst = (Sint8)rate;
+        frameStart = Now();
+    }
+
+    /** @brief Inicio do frame (logo depois do Synchronize)
+     * @return Ticks de simulacao a rodar: campos desde o frame anterior, de 1 a MaxTicks
+     */
+    uint8_t BeginFrame()
+    {
+        uint16_t now = Now();
+        uint16_t elapsed = (uint16_t)(now - frameStart); // 16 bits dao ~0,3 s
+        frameStart = now;
+
+        uint32_t count = ((uint32_t)elapsed + config.fieldTicks / 2) / config.fieldTicks;
+        fields = (uint8_t)(count < 1 ? 1 : (count > MaxTicks ? MaxTicks : count));
+        return fields;
+    }
+
+    /** @brief Fim do trabalho de CPU do frame (antes do Synchronize): mede e decide ritmo e vies
+     */
+    void EndFrame()
+    {
+        uint32_t cost = (uint16_t)(Now() - frameStart);
+        uint32_t sample = cost * 100 / config.fieldTicks;
+        load = (uint16_t)((load * 3 + (sample > 400 ? 400 : sample)) / 4);
+
+        bool missed = fields > rate; // frame anterior passou do prazo (CPU ou VDP1)
+        if (rate == 1) Govern60(missed);
+        else Govern30();
+    }
+
+    void Govern60(bool missed)
+    {
+        if (missed || load > config.raiseLoad)
+        {
+            under = 0;
+            if (++over < config.raiseFrames) return;
+
+            over = 0;
+            if (bias < MaxBias) ++bias;
+            else SetRate(2);
+        }
+        else if (load < config.lowerLoad && bias > 0)
+        {
+            over = 0;
+            if (++under < config.lowerFrames) return;
+
+            under = 0;
+            --bias;
+        }
+        else
+        {
+            over = under = 0;
+        }
+    }
+
+    // Em 30 Hz o vies fica no maximo: a carga medida e a que 60 Hz teria logo na volta
+    void Govern30()
+    {
+        if (load >= config.recoverLoad)
+        {
+            under = 0;
+            return;
+        }
+        if (++under < config.recoverFrames) return;
+
+        under = 0;
+        SetRate(1);
+    }
+
+    void SetRate(uint8_t fieldsPerFrame)
+    {
+        rate = fieldsPerFrame;
+        over = under = 0;
+        SynchConst = (Sint8)rate;
+    }
+};
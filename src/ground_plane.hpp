@@ -0,0 +1,153 @@
+#pragma once
+
+#include <srl.hpp>
+#include "srl_tga.hpp"
+#include "cd_directory.hpp"
+#include "vdp2_planner.hpp"
+#include "camera_controller.hpp"
+
+// Chao distante em RBG0 (estilo Mode-7): plano repetido com a textura de grama e
+// tabela de coeficientes por linha. Cobre grama/area de escape alem da pista sem VDP1.
+// Cada banco do RBG0 guarda um tipo so; em bitmap o chao ocupa dois (coeficientes em B0, bitmap em A1)
+// em vez de tres (coeficiente, celula e nome de padrao), e A0/B1 ficam para as camadas NBG.
+struct GroundPlane
+{
+    // Tabela de coeficientes (2 words por linha) gerada por slMakeKtable
+    static constexpr uint32_t KTableBytes = 0x10000;
+    static constexpr uint16_t BitmapWidth = 512;  // BM_512x256 @ 8bpp = banco inteiro
+    static constexpr uint16_t BitmapHeight = 256;
+
+    void* kTable = nullptr;
+    uint8_t* bitmap = nullptr;
+    int32_t paletteId = -1;
+    SRL::Math::Types::Fxp worldScale = SRL::Math::Types::Fxp(1.0f);    // unidade do mundo -> pixel do plano
+    SRL::Math::Types::Fxp eyeHeight = SRL::Math::Types::Fxp::Convert(48); // altura do olho sobre o chao
+    SRL::Math::Types::Fxp pitchFactor = SRL::Math::Types::Fxp(1.0f);
+    bool loaded = false;
+
+    // Texturas do INTLAGOS.NYA que o plano substitui: com o plano carregado o TrackRenderer tira essas faces
+    static constexpr const char* CoveredTextures[] = {
+        "grama-verde-foto_64",
+        "grama_lateral_64",
+        "grama_lugar_alto_64",
+    };
+
+    // Nome com tamanho (linha do INTLAGOS.MAP, sem '\0')
+    static bool Covers(const char* textureName, size_t length)
+    {
+        for (const char* covered : CoveredTextures)
+        {
+            size_t i = 0;
+            while (i < length && covered[i] != '\0' && covered[i] == textureName[i]) ++i;
+            if (i == length && covered[i] == '\0') return true;
+        }
+        return false;
+    }
+
+    /** @brief Repete a textura (lados divisores de 512x256) pelo bitmap inteiro
+     * @note Palavras de 32 bits na VRAM; a textura repetida no bitmap e o bitmap repetido no plano (slOverRA)
+     */
+    void Fill(const uint8_t* texel, uint16_t width, uint16_t height)
+    {
+        uint32_t* out = (uint32_t*)bitmap;
+        for (uint16_t y = 0; y < BitmapHeight; ++y)
+        {
+            const uint8_t* row = texel + (y % height) * width;
+            for (uint16_t x = 0; x < BitmapWidth; x += 4)
+            {
+                *out++ = ((uint32_t)row[x % width] << 24) | ((uint32_t)row[(x + 1) % width] << 16) |
+                         ((uint32_t)row[(x + 2) % width] << 8) | row[(x + 3) % width];
+            }
+        }
+    }
+
+    bool Load(const char* const* paths, size_t count)
+    {
+        loaded = false;
+
+        // RBG0 deve ser configurado antes das demais camadas
+        SRL::VDP2::RBG0::SetRotationMode(SRL::VDP2::RotationMode::OneAxis);
+
+        const CdDirectory::Entry* entry = CdDirectory::Resolve(paths, count);
+        if (entry == nullptr)
+        {
+            SRL::Debug::Print(1, 13, "Ground missing");
+            return false;
+        }
+
+        if (kTable == nullptr)
+        {
+            // Inicio do B0 (metade do banco); o planner acusa outra camada que ler do B0 com o RBG0 ligado
+            kTable = Vdp2Planner::Allocate("ground coef", Vdp2Planner::Usage::Coefficient, KTableBytes, 0x20000, SRL::VDP2::VramBank::B0,
+                                           Vdp2Planner::CyclesFor(Vdp2Planner::Usage::Coefficient));
+        }
+
+        if (bitmap == nullptr)
+        {
+            // A1 inteiro: nenhuma outra camada le deste banco
+            bitmap = (uint8_t*)Vdp2Planner::Allocate("ground bmp", Vdp2Planner::Usage::Bitmap, BitmapWidth * BitmapHeight, 0x20000, SRL::VDP2::VramBank::A1,
+                                                     Vdp2Planner::CyclesFor(Vdp2Planner::Usage::Bitmap), Vdp2Planner::Layer::Rotation);
+        }
+
+        if (paletteId < 0)
+        {
+            paletteId = SRL::CRAM::GetFreeBank(SRL::CRAM::TextureColorMode::Paletted256);
+            if (paletteId >= 0) SRL::CRAM::SetBankUsedState(paletteId, SRL::CRAM::TextureColorMode::Paletted256, true);
+        }
+
+        if (kTable == nullptr || bitmap == nullptr || paletteId < 0)
+        {
+            SRL::Debug::Print(1, 13, "Ground: sem VRAM/CRAM");
+            return false;
+        }
+
+        {
+            CdDirectory::ScopedDir dir(entry);
+            SRL::Cd::File groundFile(entry->name);
+            SRL::Bitmap::TGA groundBmp(&groundFile);
+            auto info = groundBmp.GetInfo();
+            if (info.ColorMode != SRL::CRAM::TextureColorMode::Paletted256 || info.Width == 0 || info.Height == 0 ||
+                BitmapWidth % info.Width != 0 || BitmapHeight % info.Height != 0)
+            {
+                SRL::Debug::Print(1, 13, "Ground invalido %ux%u mode %d", info.Width, info.Height, (int)info.ColorMode);
+                return false;
+            }
+
+            SRL::CRAM::Palette palette(SRL::CRAM::TextureColorMode::Paletted256, paletteId);
+            palette.Load((SRL::Types::HighColor*)info.Palette, 256);
+            Fill((const uint8_t*)groundBmp.GetData(), info.Width, info.Height);
+            SRL::Debug::Print(1, 13, "Ground bitmap: %ux%u em 512x256", info.Width, info.Height);
+        }
+
+        slInitBitMapRbg0(BM_512x256, bitmap);
+        slBitMapRbg0(COL_TYPE_256, paletteId, bitmap);
+
+        // Coeficiente por linha: escala cresce com a distancia, linhas acima do horizonte ficam transparentes
+        slMakeKtable(kTable);
+        slKtableRA(kTable, K_FIX | K_DOT | K_2WORD | K_ON);
+        slOverRA(0); // repete o plano ate o horizonte
+
+        SRL::VDP2::RBG0::SetPriority(SRL::VDP2::Priority::Layer6); // mesmo nivel do ceu, RBG0 vence NBG0
+        SRL::VDP2::RBG0::ScrollEnable();
+        loaded = true;
+        return true;
+    }
+
+    void Update(const Camera::State& camera)
+    {
+        if (!loaded) return;
+
+        auto heading = SRL::Math::Types::Angle::FromDegrees(SRL::Math::Types::Fxp::Convert(camera.yawDeg + camera.viewYawDeg));
+        auto tilt = SRL::Math::Types::Angle::FromDegrees(SRL::Math::Types::Fxp::Convert(-90) + SRL::Math::Types::Fxp::Convert(camera.viewPitchDeg) * pitchFactor);
+        SRL::Math::Types::Fxp planeX = camera.location.X * worldScale;
+        SRL::Math::Types::Fxp planeY = camera.location.Z * worldScale;
+
+        slPushMatrix();
+        slUnitMatrix(nullptr);
+        slRotX(tilt.RawValue());
+        slRotZ(heading.RawValue());
+        slTranslate(planeX.RawValue(), planeY.RawValue(), (eyeHeight - camera.location.Y).RawValue());
+        SRL::VDP2::RBG0::SetCurrentTransform();
+        slPopMatrix();
+    }
+};
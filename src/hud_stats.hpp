@@ -1,10 +1,54 @@
 #pragma once
 
 #include <srl.hpp>
+#include <vector>
 #include "camera_controller.hpp"
+#include "hud_text.hpp"
+#include "vdp2_planner.hpp"
+#include "work_ram.hpp"
 
 struct HudStats
 {
+    // Tres campos X Y Z de uma linha "Rotulo: x y z"
+    struct VectorFields
+    {
+        HudText::Field x, y, z;
+    };
+
+    HudText text;
+
+    HudText::Field faces{7, 2, 5}, verts{19, 2, 5}, meshes{33, 2, 3}, smooth{39, 2, 1};
+    VectorFields center = Row(3), offset = Row(4), cam = Row(5), minField = Row(6), maxField = Row(7), modelPos = Row(9);
+    HudText::Field yaw{5, 8, 5}, pitch{18, 8, 5}, radius{26, 8, 4};
+    VectorFields wheels[4] = {Row(10), Row(11), Row(12), Row(14)};
+    VectorFields wheel3Pivot = Row(13);
+
+    HudText::Field conflicts{37, 19, 3};
+    static constexpr uint8_t ConflictRow = 27; // ultimo conflito do planner (linha livre do HUD)
+    size_t shownConflicts = 0;
+    HudText::Field bankFree[4] = {{27, 20, 4}, {27, 21, 4}, {27, 22, 4}, {27, 23, 4}};
+    HudText::Field bankCycles[4] = {{35, 20, 2}, {35, 21, 2}, {35, 22, 2}, {35, 23, 2}};
+    HudText::Field vdp1Free{34, 24, 4};
+
+    // Mapa de memoria de trabalho (boot)
+    HudText::Field ramFree[WorkRam::RegionCount] = {{7, 15, 4}, {7, 16, 4}};
+    HudText::Field ramPeak[WorkRam::RegionCount] = {{16, 15, 4}, {16, 16, 4}};
+    HudText::Field ramFallback{9, 17, 2};
+    HudText::Field ramLargest[WorkRam::RegionCount] = {{7, 18, 4}, {7, 19, 4}};
+    static constexpr uint8_t OwnerColumns = 9; // dono do maior bloco, antes do rotulo do VDP2 na linha 19
+
+    static constexpr VectorFields Row(uint8_t row)
+    {
+        return VectorFields{{9, row, 6}, {16, row, 6}, {23, row, 6}};
+    }
+
+    void Vector(VectorFields& fields, const SRL::Math::Types::Vector3D& v)
+    {
+        text.Number(fields.x, v.X.As<int16_t>());
+        text.Number(fields.y, v.Y.As<int16_t>());
+        text.Number(fields.z, v.Z.As<int16_t>());
+    }
+
     void Init(uint32_t faceCount,
               uint32_t vertexCount,
               uint32_t meshCount,
@@ -13,12 +57,77 @@ struct HudStats
               const SRL::Math::Types::Vector3D& minV,
               const SRL::Math::Types::Vector3D& maxV)
     {
-        SRL::Debug::Print(1, 1, "CAR1.NYA viewer");
-        SRL::Debug::Print(1, 2, "Faces:%u Verts:%u Meshes:%u Smooth:%d", faceCount, vertexCount, meshCount, isSmooth ? 1 : 0);
-        SRL::Debug::Print(1, 3, "Center: %d, %d, %d", modelCenter.X.As<int16_t>(), modelCenter.Y.As<int16_t>(), modelCenter.Z.As<int16_t>());
-        SRL::Debug::Print(1, 6, "Min: %d %d %d", minV.X.As<int16_t>(), minV.Y.As<int16_t>(), minV.Z.As<int16_t>());
-        SRL::Debug::Print(1, 7, "Max: %d %d %d", maxV.X.As<int16_t>(), maxV.Y.As<int16_t>(), maxV.Z.As<int16_t>());
-        SRL::Debug::Print(1, 9, "Model pos: %d %d %d", modelCenter.X.As<int16_t>(), modelCenter.Y.As<int16_t>(), modelCenter.Z.As<int16_t>());
+        text.Init();
+
+        // Linhas que o HUD assume deixam de usar o texto de debug
+        for (uint8_t row = 1; row <= 14; ++row) SRL::Debug::PrintClearLine(row);
+
+        // Rotulos fixos: escritos uma unica vez
+        text.Text(1, 1, "CAR1.NYA viewer");
+        text.Text(1, 2, "Faces:      Verts:       Meshes:    S:");
+        text.Text(1, 3, "Center:");
+        text.Text(1, 4, "Offset:");
+        text.Text(1, 5, "Cam:");
+        text.Text(1, 6, "Min:");
+        text.Text(1, 7, "Max:");
+        text.Text(1, 8, "Yaw:       Pitch:      R:");
+        text.Text(1, 9, "Model:");
+        text.Text(1, 10, "Roda_1:");
+        text.Text(1, 11, "Roda_2:");
+        text.Text(1, 12, "Roda_3:");
+        text.Text(1, 13, "R3 piv:");
+        text.Text(1, 14, "Roda_4:");
+        text.Text(22, 19, "VDP2 conflitos:");
+        text.Text(24, 20, "A0:    K  c");
+        text.Text(24, 21, "A1:    K  c");
+        text.Text(24, 22, "B0:    K  c");
+        text.Text(24, 23, "B1:    K  c");
+        text.Text(24, 24, "VDP1 VRAM:    K");
+
+        text.Number(faces, (int32_t)faceCount);
+        text.Number(verts, (int32_t)vertexCount);
+        text.Number(meshes, (int32_t)meshCount);
+        text.Number(smooth, isSmooth ? 1 : 0);
+        Vector(center, modelCenter);
+        Vector(minField, minV);
+        Vector(maxField, maxV);
+        Vector(modelPos, modelCenter);
+    }
+
+    /** @brief Relatorio de memoria de trabalho: livre e pico por regiao, maior bloco vivo de cada uma e
+     * pedidos de LWRAM que foram para a HWRAM
+     * @note Chamar depois dos loads de boot (os buffers de arquivo ja foram liberados, o pico fica)
+     */
+    void MemoryReport()
+    {
+        text.Text(1, 17, "LW->HW:");
+        for (size_t region = 0; region < WorkRam::RegionCount; ++region)
+        {
+            uint8_t row = ramFree[region].row;
+            text.Text(1, row, WorkRam::RegionNames[region]);
+            text.Text(6, row, ":    K  pk    K");
+            text.Number(ramFree[region], (int32_t)(WorkRam::FreeBytes((WorkRam::Region)region) / 1024));
+            text.Number(ramPeak[region], (int32_t)(WorkRam::peak[region] / 1024));
+
+            // "LWRAM> 128K sky stagi": maior bloco vivo, dono cortado em OwnerColumns
+            row = ramLargest[region].row;
+            text.Text(1, row, WorkRam::RegionNames[region]);
+            text.Text(6, row, ">    K");
+            const WorkRam::Block* largest = WorkRam::Largest((WorkRam::Region)region);
+            if (largest == nullptr) continue;
+
+            char owner[OwnerColumns + 1];
+            size_t length = 0;
+            while (largest->owner[length] != '\0' && length < OwnerColumns)
+            {
+                owner[length] = largest->owner[length];
+                ++length;
+            }
+            owner[length] = '\0';
+            text.Number(ramLargest[region], (int32_t)((largest->size + 1023) / 1024));
+            text.Text(13, row, owner);
+        }
+        text.Number(ramFallback, (int32_t)WorkRam::fallbackCount);
     }
 
     void Update(const Camera::State& cameraState,
@@ -26,16 +135,47 @@ struct HudStats
                 const SRL::Math::Types::Vector3D& cameraLocation,
                 const SRL::Math::Types::Vector3D& modelCenter)
     {
-        SRL::Debug::Print(1, 4, "Offset: %d, %d, %d", modelOffset.X.As<int16_t>(), modelOffset.Y.As<int16_t>(), modelOffset.Z.As<int16_t>());
-        SRL::Debug::Print(1, 5, "Cam: %d, %d, %d", cameraLocation.X.As<int16_t>(), cameraLocation.Y.As<int16_t>(), cameraLocation.Z.As<int16_t>());
-        SRL::Debug::Print(1, 8, "Yaw:%u Pitch:%u R:%d", cameraState.yaw.RawValue(), cameraState.pitch.RawValue(), cameraState.radius.As<int16_t>());
+        Vector(offset, modelOffset);
+        Vector(cam, cameraLocation);
+        text.Number(yaw, (int32_t)cameraState.yaw.RawValue());
+        text.Number(pitch, (int32_t)cameraState.pitch.RawValue());
+        text.Number(radius, cameraState.radius.As<int16_t>());
 
         // VDP usage (live)
-        auto bankFree = [&](int bank)->int32_t { return (int32_t)SRL::VDP2::VRAM::GetAvailable((SRL::VDP2::VramBank)bank); };
-        SRL::Debug::Print(28, 20, "VDP2 A0:%5dK", (int)(bankFree(0) / 1024));
-        SRL::Debug::Print(28, 21, "VDP2 A1:%5dK", (int)(bankFree(1) / 1024));
-        SRL::Debug::Print(28, 22, "VDP2 B0:%5dK", (int)(bankFree(2) / 1024));
-        SRL::Debug::Print(28, 23, "VDP2 B1:%5dK", (int)(bankFree(3) / 1024));
-        SRL::Debug::Print(28, 24, "VDP1 VRAM:%4dK", (int)(SRL::VDP1::GetAvailableMemory() / 1024));
+        text.Number(conflicts, (int32_t)Vdp2Planner::conflictCount);
+        for (size_t bank = 0; bank < 4; ++bank)
+        {
+            text.Number(bankFree[bank], (int32_t)(SRL::VDP2::VRAM::GetAvailable((SRL::VDP2::VramBank)bank) / 1024));
+            text.Number(bankCycles[bank], Vdp2Planner::FreeCycles(bank));
+        }
+        text.Number(vdp1Free, (int32_t)(SRL::VDP1::GetAvailableMemory() / 1024));
+        if (shownConflicts != Vdp2Planner::conflictCount) ShowConflict();
+    }
+
+    // "B0 ground RBG0: banco RBG0 com NBG" na linha de conflito, completada com espacos
+    void ShowConflict()
+    {
+        shownConflicts = Vdp2Planner::conflictCount;
+        if (Vdp2Planner::lastOwner == nullptr) return;
+
+        char line[HudText::Columns + 1];
+        size_t length = 0;
+        const char* parts[] = {Vdp2Planner::BankNames[Vdp2Planner::lastBank], " ", Vdp2Planner::lastOwner, ": ", Vdp2Planner::lastReason};
+        for (const char* part : parts)
+        {
+            while (*part != '\0' && length < HudText::Columns - 1) line[length++] = *part++;
+        }
+        while (length < HudText::Columns - 1) line[length++] = ' ';
+        line[length] = '\0';
+        text.Text(1, ConflictRow, line);
+    }
+
+    // Debug: posicoes das rodas (malhas 1..4) e pivo da roda 3
+    void UpdateWheels(const std::vector<SRL::Math::Types::Vector3D>& centers, const SRL::Math::Types::Vector3D& modelCenter)
+    {
+        if (centers.size() <= 4) return;
+
+        for (size_t i = 0; i < 4; ++i) Vector(wheels[i], centers[i + 1]);
+        Vector(wheel3Pivot, centers[3] - modelCenter);
     }
 };
@@ -0,0 +1,435 @@
+#pragma once
+
+#include <srl.hpp>
+#include "vdp2_planner.hpp"
+
+// Camada de texto do HUD no NBG2 (o texto de debug do SRL fica no NBG3):
+// fonte 8x8 de 16 cores gravada uma vez na VRAM, mapa espelhado em WRAM e
+// so as celulas que mudaram vao para o VDP2, no vblank.
+// No 448i (VideoMode) o NBG2 nao tem zoom: cada celula vira duas esticadas (metade de cima e de baixo)
+// e cada linha do HUD ocupa duas linhas do mapa.
+struct HudText
+{
+    static constexpr uint8_t Columns = 40; // 320 px visiveis
+    static constexpr uint8_t Rows = 28;    // 224 px visiveis
+    static constexpr uint16_t MapSize = 64;
+    static constexpr uint32_t MapBytes = MapSize * MapSize * sizeof(uint16_t);
+    static constexpr uint8_t FirstGlyph = 0x20;
+    static constexpr uint8_t GlyphCount = 64; // ' ' ate '_', minusculas viram maiusculas
+    static constexpr uint8_t CellBytes = 32;  // 8x8 @ 4bpp
+    static constexpr uint8_t MaxRanges = 4;
+    static constexpr uintptr_t CramBase = 0x25f00000;
+    static constexpr int32_t PaletteCount = 128; // 2048 cores / 16
+
+    // Indices da paleta de 16 cores (0 = transparente)
+    enum Color : uint8_t
+    {
+        ColorText = 1,
+        ColorShadow = 2,
+        ColorNeedle = 3,
+        ColorDial = 4,
+        ColorMark = 5,
+    };
+
+    // Campo numerico: so reformata quando o valor muda
+    struct Field
+    {
+        uint8_t column;
+        uint8_t row;
+        uint8_t width;
+        int32_t value = 0;
+        bool valid = false;
+    };
+
+    // Celulas que ganham copia esticada no modo alto (fonte e as de quem chamou AddCells)
+    struct CellRange
+    {
+        uint16_t first;          // numero da primeira celula
+        uint16_t count;
+        uint16_t tallFirst = 0;  // copias: duas por celula, cima e baixo
+        bool stretched = false;
+    };
+
+    // Glifos 5x7 (1 bit por pixel, bit 7 = coluna 0)
+    static constexpr uint8_t Font[GlyphCount][8] = {
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ' '
+        {0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x10, 0x00}, // !
+        {0x28, 0x28, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // "
+        {0x28, 0x7c, 0x28, 0x28, 0x28, 0x7c, 0x28, 0x00}, // #
+        {0x10, 0x3c, 0x50, 0x38, 0x14, 0x78, 0x10, 0x00}, // $
+        {0x60, 0x64, 0x08, 0x10, 0x20, 0x4c, 0x0c, 0x00}, // %
+        {0x30, 0x48, 0x50, 0x20, 0x54, 0x48, 0x34, 0x00}, // &
+        {0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '
+        {0x08, 0x10, 0x20, 0x20, 0x20, 0x10, 0x08, 0x00}, // (
+        {0x20, 0x10, 0x08, 0x08, 0x08, 0x10, 0x20, 0x00}, // )
+        {0x00, 0x10, 0x54, 0x38, 0x54, 0x10, 0x00, 0x00}, // *
+        {0x00, 0x10, 0x10, 0x7c, 0x10, 0x10, 0x00, 0x00}, // +
+        {0x00, 0x00, 0x00, 0x00, 0x30, 0x10, 0x20, 0x00}, // ,
+        {0x00, 0x00, 0x00, 0x7c, 0x00, 0x00, 0x00, 0x00}, // -
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00}, // .
+        {0x00, 0x04, 0x08, 0x10, 0x20, 0x40, 0x00, 0x00}, // /
+        {0x38, 0x44, 0x4c, 0x54, 0x64, 0x44, 0x38, 0x00}, // 0
+        {0x10, 0x30, 0x10, 0x10, 0x10, 0x10, 0x38, 0x00}, // 1
+        {0x38, 0x44, 0x04, 0x08, 0x10, 0x20, 0x7c, 0x00}, // 2
+        {0x7c, 0x08, 0x10, 0x08, 0x04, 0x44, 0x38, 0x00}, // 3
+        {0x08, 0x18, 0x28, 0x48, 0x7c, 0x08, 0x08, 0x00}, // 4
+        {0x7c, 0x40, 0x78, 0x04, 0x04, 0x44, 0x38, 0x00}, // 5
+        {0x18, 0x20, 0x40, 0x78, 0x44, 0x44, 0x38, 0x00}, // 6
+        {0x7c, 0x04, 0x08, 0x10, 0x20, 0x20, 0x20, 0x00}, // 7
+        {0x38, 0x44, 0x44, 0x38, 0x44, 0x44, 0x38, 0x00}, // 8
+        {0x38, 0x44, 0x44, 0x3c, 0x04, 0x08, 0x30, 0x00}, // 9
+        {0x00, 0x30, 0x30, 0x00, 0x30, 0x30, 0x00, 0x00}, // :
+        {0x00, 0x30, 0x30, 0x00, 0x30, 0x10, 0x20, 0x00}, // ;
+        {0x08, 0x10, 0x20, 0x40, 0x20, 0x10, 0x08, 0x00}, // <
+        {0x00, 0x00, 0x7c, 0x00, 0x7c, 0x00, 0x00, 0x00}, // =
+        {0x20, 0x10, 0x08, 0x04, 0x08, 0x10, 0x20, 0x00}, // >
+        {0x38, 0x44, 0x04, 0x08, 0x10, 0x00, 0x10, 0x00}, // ?
+        {0x38, 0x44, 0x04, 0x34, 0x54, 0x54, 0x38, 0x00}, // @
+        {0x38, 0x44, 0x44, 0x7c, 0x44, 0x44, 0x44, 0x00}, // A
+        {0x78, 0x44, 0x44, 0x78, 0x44, 0x44, 0x78, 0x00}, // B
+        {0x38, 0x44, 0x40, 0x40, 0x40, 0x44, 0x38, 0x00}, // C
+        {0x70, 0x48, 0x44, 0x44, 0x44, 0x48, 0x70, 0x00}, // D
+        {0x7c, 0x40, 0x40, 0x78, 0x40, 0x40, 0x7c, 0x00}, // E
+        {0x7c, 0x40, 0x40, 0x78, 0x40, 0x40, 0x40, 0x00}, // F
+        {0x38, 0x44, 0x40, 0x5c, 0x44, 0x44, 0x3c, 0x00}, // G
+        {0x44, 0x44, 0x44, 0x7c, 0x44, 0x44, 0x44, 0x00}, // H
+        {0x38, 0x10, 0x10, 0x10, 0x10, 0x10, 0x38, 0x00}, // I
+        {0x1c, 0x08, 0x08, 0x08, 0x08, 0x48, 0x30, 0x00}, // J
+        {0x44, 0x48, 0x50, 0x60, 0x50, 0x48, 0x44, 0x00}, // K
+        {0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x7c, 0x00}, // L
+        {0x44, 0x6c, 0x54, 0x54, 0x44, 0x44, 0x44, 0x00}, // M
+        {0x44, 0x44, 0x64, 0x54, 0x4c, 0x44, 0x44, 0x00}, // N
+        {0x38, 0x44, 0x44, 0x44, 0x44, 0x44, 0x38, 0x00}, // O
+        {0x78, 0x44, 0x44, 0x78, 0x40, 0x40, 0x40, 0x00}, // P
+        {0x38, 0x44, 0x44, 0x44, 0x54, 0x48, 0x34, 0x00}, // Q
+        {0x78, 0x44, 0x44, 0x78, 0x50, 0x48, 0x44, 0x00}, // R
+        {0x3c, 0x40, 0x40, 0x38, 0x04, 0x04, 0x78, 0x00}, // S
+        {0x7c, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00}, // T
+        {0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x38, 0x00}, // U
+        {0x44, 0x44, 0x44, 0x44, 0x44, 0x28, 0x10, 0x00}, // V
+        {0x44, 0x44, 0x44, 0x54, 0x54, 0x54, 0x28, 0x00}, // W
+        {0x44, 0x44, 0x28, 0x10, 0x28, 0x44, 0x44, 0x00}, // X
+        {0x44, 0x44, 0x28, 0x10, 0x10, 0x10, 0x10, 0x00}, // Y
+        {0x7c, 0x04, 0x08, 0x10, 0x20, 0x40, 0x7c, 0x00}, // Z
+        {0x38, 0x20, 0x20, 0x20, 0x20, 0x20, 0x38, 0x00}, // [
+        {0x00, 0x40, 0x20, 0x10, 0x08, 0x04, 0x00, 0x00}, // barra invertida
+        {0x38, 0x08, 0x08, 0x08, 0x08, 0x08, 0x38, 0x00}, // ]
+        {0x10, 0x28, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00}, // ^
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7c, 0x00}, // _
+    };
+
+    uint8_t* cells = nullptr;
+    uint16_t* map = nullptr;
+    int32_t paletteId = -1;
+    uint16_t glyphBase = 0;  // numero de celula do glifo ' '
+    uint16_t paletteBits = 0;
+    uint16_t shadow[Rows][Columns] = {};
+    volatile uint32_t dirtyRows = 0;
+    CellRange ranges[MaxRanges] = {};
+    uint8_t rangeCount = 0;
+    bool tall = false;
+    volatile bool relayout = false;
+    uint8_t dirtyFirst[Rows] = {};
+    uint8_t dirtyLast[Rows] = {};
+    bool ready = false;
+
+    static inline HudText* uploadOwner = nullptr;
+
+    ~HudText()
+    {
+        if (uploadOwner == this)
+        {
+            SRL::Core::OnVblank -= Upload;
+            uploadOwner = nullptr;
+        }
+    }
+
+    /** @brief Reserva fonte e mapa em A0, grava os glifos e liga o NBG2
+     */
+    bool Init()
+    {
+        if (ready) return true;
+
+        cells = (uint8_t*)Vdp2Planner::Allocate("hud font", Vdp2Planner::Usage::Character, GlyphCount * CellBytes, CellBytes, SRL::VDP2::VramBank::A0,
+                                                Vdp2Planner::CyclesFor(Vdp2Planner::Usage::Character, SRL::CRAM::TextureColorMode::Paletted16));
+        map = (uint16_t*)Vdp2Planner::Allocate("hud map", Vdp2Planner::Usage::PatternName, MapBytes, 0x2000, SRL::VDP2::VramBank::A0,
+                                               Vdp2Planner::CyclesFor(Vdp2Planner::Usage::PatternName));
+        paletteId = SRL::CRAM::GetFreeBank(SRL::CRAM::TextureColorMode::Paletted16);
+        if (cells == nullptr || map == nullptr || paletteId < 0 || paletteId >= PaletteCount)
+        {
+            SRL::Debug::Print(1, 13, "HUD: sem VRAM/CRAM");
+            return false;
+        }
+        SRL::CRAM::SetBankUsedState(paletteId, SRL::CRAM::TextureColorMode::Paletted16, true);
+
+        uint16_t colors[16] = {};
+        colors[ColorText] = 0xffff;
+        colors[ColorShadow] = 0x8000;
+        colors[ColorNeedle] = 0x801f;  // vermelho
+        colors[ColorDial] = 0xc210;    // cinza
+        colors[ColorMark] = 0x83ff;    // amarelo
+        SRL::CRAM::Palette palette(SRL::CRAM::TextureColorMode::Paletted16, paletteId);
+        palette.Load((SRL::Types::HighColor*)colors, 16);
+
+        // Glifo com sombra 1 px para baixo/direita, 4 bytes por linha (pixel par no nibble alto)
+        for (uint8_t glyph = 0; glyph < GlyphCount; ++glyph)
+        {
+            uint32_t* dst = (uint32_t*)(cells + glyph * CellBytes);
+            for (uint8_t y = 0; y < 8; ++y)
+            {
+                uint8_t text = Font[glyph][y];
+                uint8_t shade = y > 0 ? (uint8_t)(Font[glyph][y - 1] >> 1) : 0;
+                uint32_t line = 0;
+                for (uint8_t x = 0; x < 8; ++x)
+                {
+                    uint8_t bit = 0x80 >> x;
+                    uint32_t pixel = (text & bit) ? ColorText : ((shade & bit) ? ColorShadow : 0);
+                    line |= pixel << (28 - x * 4);
+                }
+                dst[y] = line;
+            }
+        }
+
+        glyphBase = (uint16_t)((((uint32_t)cells & 0x7ffff) >> 5) & 0x0fff);
+        // Palheta de 7 bits: os 4 de baixo vao em cada nome, os 3 de cima no registro do NBG2 (via col_adr)
+        paletteBits = (uint16_t)((paletteId & 0x0f) << 12);
+        AddCells(cells, GlyphCount);
+
+        const uint16_t blank = Glyph(' ');
+        for (uint32_t i = 0; i < (uint32_t)MapSize * MapSize; ++i) map[i] = blank;
+        for (uint8_t row = 0; row < Rows; ++row)
+        {
+            for (uint8_t column = 0; column < Columns; ++column) shadow[row][column] = blank;
+        }
+
+        slCharNbg2(COL_TYPE_16, CHAR_SIZE_1x1);
+        slPageNbg2(cells, (void*)(CramBase + paletteId * 16 * sizeof(uint16_t)), PNB_1WORD | CN_12BIT);
+        slPlaneNbg2(PL_SIZE_1x1);
+        slMapNbg2(map, map, map, map);
+        slScrPosNbg2(0, 0);
+        SRL::VDP2::NBG2::SetPriority(SRL::VDP2::Priority::Layer7);
+        SRL::VDP2::NBG2::ScrollEnable();
+
+        uploadOwner = this;
+        SRL::Core::OnVblank += Upload;
+        ready = true;
+        return true;
+    }
+
+    /** @brief Nome de padrao de celulas gravadas fora da fonte (mesmo NBG2 e paleta)
+     * @param address Celula 4bpp na VRAM
+     */
+    uint16_t CellName(const void* address) const
+    {
+        return (uint16_t)(paletteBits | ((((uint32_t)address & 0x7ffff) >> 5) & 0x0fff));
+    }
+
+    /** @brief Registra celulas desenhadas fora da fonte para o modo alto
+     * @param address Primeira celula 4bpp na VRAM
+     */
+    bool AddCells(const void* address, uint16_t count)
+    {
+        if (cells == nullptr || rangeCount >= MaxRanges) return false;
+        ranges[rangeCount].first = (uint16_t)(CellName(address) & 0x0fff);
+        ranges[rangeCount].count = count;
+        ranges[rangeCount].stretched = false;
+        ++rangeCount;
+        return !tall || Stretch(ranges[rangeCount - 1]);
+    }
+
+    // Copias de 8x8 em duas celulas com cada linha repetida (so no primeiro uso do modo alto)
+    bool Stretch(CellRange& range)
+    {
+        if (range.stretched) return true;
+
+        uint8_t* copies = (uint8_t*)Vdp2Planner::Allocate("hud tall", Vdp2Planner::Usage::Character, range.count * 2 * CellBytes, CellBytes,
+                                                          SRL::VDP2::VramBank::A0, 0);
+        if (copies == nullptr) return false;
+
+        const uint8_t* vram = (const uint8_t*)((uint32_t)cells & ~0x7ffff);
+        for (uint16_t cell = 0; cell < range.count; ++cell)
+        {
+            const uint32_t* src = (const uint32_t*)(vram + (uint32_t)(range.first + cell) * CellBytes);
+            uint32_t* upper = (uint32_t*)(copies + cell * 2 * CellBytes);
+            uint32_t* lower = upper + CellBytes / sizeof(uint32_t);
+            for (uint8_t y = 0; y < 8; ++y)
+            {
+                upper[y] = src[y / 2];
+                lower[y] = src[4 + y / 2];
+            }
+        }
+        range.tallFirst = (uint16_t)((((uint32_t)copies & 0x7ffff) >> 5) & 0x0fff);
+        range.stretched = true;
+        return true;
+    }
+
+    /** @brief Liga ou desliga as celulas esticadas (448i); o mapa inteiro e reescrito no proximo vblank
+     * @return false sem VRAM para as copias (fica no modo anterior)
+     */
+    bool SetTall(bool on)
+    {
+        if (!ready) return false;
+        if (on == tall) return true;
+        for (uint8_t r = 0; on && r < rangeCount; ++r)
+        {
+            if (!Stretch(ranges[r])) return false;
+        }
+
+        tall = on;
+        for (uint8_t row = 0; row < Rows; ++row)
+        {
+            dirtyFirst[row] = 0;
+            dirtyLast[row] = Columns - 1;
+        }
+        relayout = true;
+        dirtyRows = (1u << Rows) - 1;
+        return true;
+    }
+
+    // Metade (0 = cima, 1 = baixo) de um nome no modo alto
+    uint16_t TallName(uint16_t name, uint8_t half) const
+    {
+        uint16_t cell = name & 0x0fff;
+        for (uint8_t r = 0; r < rangeCount; ++r)
+        {
+            const CellRange& range = ranges[r];
+            if (range.stretched && cell >= range.first && cell < range.first + range.count)
+            {
+                return (uint16_t)((name & 0xf000) | ((range.tallFirst + (cell - range.first) * 2 + half) & 0x0fff));
+            }
+        }
+        return name;
+    }
+
+    // Nome de padrao de um caractere
+    uint16_t Glyph(char c) const
+    {
+        if (c >= 'a' && c <= 'z') c = (char)(c - 'a' + 'A');
+        uint8_t index = ((uint8_t)c >= FirstGlyph && (uint8_t)c < FirstGlyph + GlyphCount) ? (uint8_t)(c - FirstGlyph) : 0;
+        return (uint16_t)(paletteBits | ((glyphBase + index) & 0x0fff));
+    }
+
+    void Put(uint8_t column, uint8_t row, char c)
+    {
+        PutName(column, row, Glyph(c));
+    }
+
+    void PutName(uint8_t column, uint8_t row, uint16_t name)
+    {
+        if (!ready || column >= Columns || row >= Rows) return;
+        if (shadow[row][column] == name) return;
+        shadow[row][column] = name;
+
+        // Faixa primeiro, bit depois: o vblank nunca ve o bit sem a faixa
+        uint32_t bit = 1u << row;
+        if ((dirtyRows & bit) == 0)
+        {
+            dirtyFirst[row] = column;
+            dirtyLast[row] = column;
+        }
+        else
+        {
+            if (column < dirtyFirst[row]) dirtyFirst[row] = column;
+            if (column > dirtyLast[row]) dirtyLast[row] = column;
+        }
+        dirtyRows |= bit;
+    }
+
+    /** @brief Escreve um texto fixo (rotulo); celulas iguais nao sao reenviadas
+     */
+    void Text(uint8_t column, uint8_t row, const char* text)
+    {
+        for (; *text != '\0' && column < Columns; ++text, ++column) Put(column, row, *text);
+    }
+
+    /** @brief Escreve um inteiro alinhado a direita no campo, so se o valor mudou
+     */
+    void Number(Field& field, int32_t value)
+    {
+        if (field.valid && field.value == value) return;
+        field.value = value;
+        field.valid = true;
+
+        char digits[12];
+        uint8_t count = 0;
+        bool negative = value < 0;
+        uint32_t magnitude = negative ? (uint32_t)(-(int64_t)value) : (uint32_t)value;
+        do
+        {
+            digits[count++] = (char)('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0 && count < sizeof(digits) - 1);
+        if (negative) digits[count++] = '-';
+
+        // Nao cabe: preenche com '*' como o printf faria sem truncar
+        if (count > field.width)
+        {
+            for (uint8_t i = 0; i < field.width; ++i) Put(field.column + i, field.row, '*');
+            return;
+        }
+
+        uint8_t pad = field.width - count;
+        for (uint8_t i = 0; i < pad; ++i) Put(field.column + i, field.row, ' ');
+        for (uint8_t i = 0; i < count; ++i) Put(field.column + pad + i, field.row, digits[count - 1 - i]);
+    }
+
+    /** @brief Tempo de volta "M:SS.CC" (7 celulas) a partir de ticks de 60 Hz
+     */
+    void Time(Field& field, uint32_t ticks)
+    {
+        if (field.valid && field.value == (int32_t)ticks) return;
+        field.value = (int32_t)ticks;
+        field.valid = true;
+
+        uint32_t seconds = ticks / 60;
+        uint32_t hundredths = (ticks % 60) * 100 / 60;
+        uint32_t minutes = seconds / 60;
+        seconds %= 60;
+
+        char time[7] = {(char)('0' + minutes % 10), ':', (char)('0' + seconds / 10), (char)('0' + seconds % 10), '.',
+                        (char)('0' + hundredths / 10), (char)('0' + hundredths % 10)};
+        for (uint8_t i = 0; i < 7 && i < field.width; ++i) Put(field.column + i, field.row, time[i]);
+    }
+
+    // Copia para a VRAM so as faixas alteradas (chamado no vblank)
+    static void Upload()
+    {
+        HudText* self = uploadOwner;
+        if (self == nullptr) return;
+
+        uint32_t rows = self->dirtyRows;
+        if (rows == 0) return;
+        self->dirtyRows = 0;
+
+        // Saindo do modo alto: a metade de baixo do mapa fica vazia
+        if (self->relayout)
+        {
+            self->relayout = false;
+            const uint16_t blank = self->Glyph(' ');
+            for (uint32_t i = Rows * MapSize; !self->tall && i < 2u * Rows * MapSize; ++i) self->map[i] = blank;
+        }
+
+        for (uint8_t row = 0; rows != 0; ++row, rows >>= 1)
+        {
+            if ((rows & 1) == 0) continue;
+
+            if (self->tall)
+            {
+                uint16_t* upper = self->map + row * 2 * MapSize;
+                uint16_t* lower = upper + MapSize;
+                for (uint8_t column = self->dirtyFirst[row]; column <= self->dirtyLast[row]; ++column)
+                {
+                    upper[column] = self->TallName(self->shadow[row][column], 0);
+                    lower[column] = self->TallName(self->shadow[row][column], 1);
+                }
+                continue;
+            }
+
+            uint16_t* dst = self->map + row * MapSize;
+            for (uint8_t column = self->dirtyFirst[row]; column <= self->dirtyLast[row]; ++column)
+            {
+                dst[column] = self->shadow[row][column];
+            }
+        }
+    }
+};
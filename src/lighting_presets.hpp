@@ -0,0 +1,98 @@
+#pragma once
+
+#include <srl.hpp>
+#include "lighting_tables.hpp"
+
+// Presets de luz do carro: cada um e uma tabela de gouraud de 32 entradas gerada offline das imagens de ceu
+// (tools/skylight -> lighting_tables.hpp). O SGL le a tabela ativa a cada vertice iluminado, entao trocar
+// o clima ou entrar sob uma cobertura custa so reescrever 32 cores; a troca e misturada em alguns frames.
+// A mesma tabela ilumina as faces da pista que usam gouraud.
+struct LightingPresets
+{
+    static constexpr size_t Entries = 32;
+    static constexpr uint8_t BlendFrames = 20;
+
+    // Um preset por ceu do CD (mesma ordem do ciclo de ceus) e o de cobertura, de cor fixa
+    enum class Preset : uint8_t
+    {
+        Skybox1,
+        Skybox3,
+        Skybox4,
+        Skybox5,
+        Ceu,
+        Tunnel,
+    };
+
+    SRL::Types::HighColor active[Entries]; // passada uma vez ao LightSetGouraudTable
+    uint8_t from[Entries][3] = {};
+    uint8_t now[Entries][3] = {};
+    Preset base = Preset::Skybox1;   // do ceu atual
+    Preset target = Preset::Skybox1; // base ou Tunnel
+    uint8_t step = BlendFrames;
+
+    static const uint8_t (*Table(Preset preset))[3]
+    {
+        switch (preset)
+        {
+        case Preset::Skybox3: return LightingTables::Skybox3;
+        case Preset::Skybox4: return LightingTables::Skybox4;
+        case Preset::Skybox5: return LightingTables::Skybox5;
+        case Preset::Ceu: return LightingTables::Ceu;
+        case Preset::Tunnel: return LightingTables::Tunnel;
+        default: return LightingTables::Skybox1;
+        }
+    }
+
+    void Write()
+    {
+        for (size_t i = 0; i < Entries; ++i) active[i] = SRL::Types::HighColor::FromRGB555(now[i][0], now[i][1], now[i][2]);
+    }
+
+    void Init(Preset preset)
+    {
+        base = target = preset;
+        step = BlendFrames;
+        const uint8_t (*table)[3] = Table(preset);
+        for (size_t i = 0; i < Entries; ++i)
+        {
+            for (size_t c = 0; c < 3; ++c) now[i][c] = table[i][c];
+        }
+        Write();
+    }
+
+    // Troca de ceu: vale na proxima chamada de Update
+    void SetBase(Preset preset)
+    {
+        base = preset;
+    }
+
+    /** @brief Avanca a mistura (uma vez por frame, antes de desenhar)
+     * @param covered Carro sob cobertura (segmento com teto)
+     */
+    void Update(bool covered)
+    {
+        Preset wanted = covered ? Preset::Tunnel : base;
+        if (wanted != target)
+        {
+            // Parte da cor do momento: inverter no meio de uma mistura nao salta
+            for (size_t i = 0; i < Entries; ++i)
+            {
+                for (size_t c = 0; c < 3; ++c) from[i][c] = now[i][c];
+            }
+            target = wanted;
+            step = 0;
+        }
+        if (step >= BlendFrames) return;
+
+        ++step;
+        const uint8_t (*table)[3] = Table(target);
+        for (size_t i = 0; i < Entries; ++i)
+        {
+            for (size_t c = 0; c < 3; ++c)
+            {
+                now[i][c] = (uint8_t)(from[i][c] + ((int32_t)table[i][c] - from[i][c]) * step / BlendFrames);
+            }
+        }
+        Write();
+    }
+};
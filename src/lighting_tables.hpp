@@ -0,0 +1,79 @@
+// Gerado por tools/skylight (nao editar a mao)
+#pragma once
+
+#include <cstdint>
+
+namespace LightingTables
+{
+    // skybox_1.tga: ceu (16, 21, 31), horizonte (13, 16, 22), brilho 100%
+    constexpr uint8_t Skybox1[32][3] = {
+        {0, 0, 0}, {1, 1, 1}, {2, 2, 2}, {3, 3, 3},
+        {4, 4, 4}, {5, 5, 5}, {6, 6, 6}, {7, 7, 8},
+        {8, 8, 9}, {8, 9, 10}, {9, 10, 11}, {10, 11, 12},
+        {11, 12, 13}, {12, 13, 14}, {13, 14, 15}, {14, 15, 16},
+        {15, 16, 17}, {16, 17, 18}, {17, 18, 20}, {18, 19, 21},
+        {19, 20, 22}, {20, 21, 23}, {21, 22, 24}, {21, 23, 25},
+        {22, 23, 26}, {23, 24, 27}, {24, 25, 29}, {24, 25, 30},
+        {24, 26, 31}, {24, 26, 31}, {23, 26, 31}, {23, 26, 31},
+    };
+
+    // skybox_3.tga: ceu (12, 19, 24), horizonte (22, 24, 26), brilho 85%
+    constexpr uint8_t Skybox3[32][3] = {
+        {0, 0, 0}, {1, 1, 1}, {2, 2, 2}, {2, 3, 3},
+        {3, 3, 3}, {4, 4, 4}, {5, 5, 5}, {6, 6, 6},
+        {7, 7, 7}, {7, 8, 8}, {8, 9, 9}, {9, 9, 10},
+        {10, 10, 11}, {10, 11, 12}, {11, 12, 12}, {12, 13, 13},
+        {13, 14, 14}, {14, 15, 15}, {14, 15, 16}, {15, 16, 17},
+        {16, 17, 18}, {17, 18, 19}, {17, 19, 20}, {18, 20, 21},
+        {19, 21, 22}, {20, 21, 23}, {20, 22, 24}, {20, 23, 25},
+        {20, 23, 26}, {20, 23, 26}, {19, 24, 27}, {19, 24, 27},
+    };
+
+    // skybox_4.tga: ceu (13, 18, 30), horizonte (25, 28, 32), brilho 100%
+    constexpr uint8_t Skybox4[32][3] = {
+        {0, 0, 0}, {1, 1, 1}, {2, 2, 2}, {3, 3, 3},
+        {4, 4, 4}, {5, 5, 5}, {6, 6, 6}, {7, 7, 7},
+        {8, 8, 8}, {9, 9, 10}, {10, 10, 11}, {10, 11, 12},
+        {11, 12, 13}, {12, 13, 14}, {13, 14, 15}, {14, 15, 16},
+        {15, 16, 17}, {16, 17, 18}, {17, 18, 19}, {18, 19, 21},
+        {19, 20, 22}, {20, 21, 23}, {20, 21, 24}, {21, 22, 25},
+        {22, 23, 26}, {23, 24, 28}, {23, 25, 29}, {23, 25, 30},
+        {23, 25, 31}, {22, 25, 31}, {22, 24, 31}, {21, 24, 31},
+    };
+
+    // skybox_5.tga: ceu (16, 21, 31), horizonte (13, 15, 22), brilho 100%
+    constexpr uint8_t Skybox5[32][3] = {
+        {0, 0, 0}, {1, 1, 1}, {2, 2, 2}, {3, 3, 3},
+        {4, 4, 4}, {5, 5, 5}, {6, 6, 6}, {7, 7, 8},
+        {8, 8, 9}, {8, 9, 10}, {9, 10, 11}, {10, 11, 12},
+        {11, 12, 13}, {12, 13, 14}, {13, 14, 15}, {14, 15, 16},
+        {15, 16, 17}, {16, 17, 18}, {17, 18, 20}, {18, 19, 21},
+        {19, 20, 22}, {20, 21, 23}, {21, 22, 24}, {21, 23, 25},
+        {22, 23, 26}, {23, 24, 27}, {24, 25, 29}, {24, 25, 30},
+        {24, 26, 31}, {23, 26, 31}, {23, 26, 31}, {23, 26, 31},
+    };
+
+    // ceu.tga: ceu (8, 15, 25), horizonte (11, 19, 27), brilho 100%
+    constexpr uint8_t Ceu[32][3] = {
+        {0, 0, 0}, {1, 1, 1}, {2, 2, 2}, {3, 3, 3},
+        {4, 4, 4}, {4, 5, 6}, {5, 6, 7}, {6, 7, 8},
+        {7, 8, 9}, {8, 9, 10}, {9, 10, 11}, {10, 11, 12},
+        {11, 12, 13}, {12, 13, 15}, {12, 14, 16}, {13, 15, 17},
+        {14, 16, 18}, {15, 17, 19}, {16, 18, 20}, {17, 19, 21},
+        {18, 20, 23}, {19, 21, 24}, {19, 22, 25}, {20, 23, 26},
+        {21, 24, 27}, {22, 25, 28}, {22, 25, 30}, {22, 25, 31},
+        {21, 25, 31}, {20, 25, 31}, {20, 25, 31}, {19, 24, 31},
+    };
+
+    // #687080: ceu (13, 14, 16), horizonte (13, 14, 16), brilho 55%
+    constexpr uint8_t Tunnel[32][3] = {
+        {0, 0, 0}, {1, 1, 1}, {1, 1, 1}, {2, 2, 2},
+        {2, 2, 2}, {3, 3, 3}, {3, 3, 3}, {4, 4, 4},
+        {4, 4, 5}, {5, 5, 5}, {5, 5, 6}, {6, 6, 6},
+        {6, 7, 7}, {7, 7, 7}, {8, 8, 8}, {8, 8, 8},
+        {9, 9, 9}, {9, 9, 10}, {10, 10, 10}, {10, 10, 11},
+        {11, 11, 11}, {11, 11, 12}, {12, 12, 12}, {12, 13, 13},
+        {13, 13, 14}, {13, 14, 14}, {14, 14, 15}, {14, 15, 16},
+        {15, 15, 16}, {15, 16, 17}, {15, 16, 17}, {15, 16, 17},
+    };
+} // namespace LightingTables
@@ -1,5 +1,7 @@
 #include <srl.hpp>
 
+#include "cd_directory.hpp"
+
 #include "modelObject.hpp"
 
 #include "camera_controller.hpp"
@@ -10,6 +12,8 @@
 
 #include "hud_stats.hpp"
 
+#include "race_hud.hpp"
+
 #include "sky_environment.hpp"
 
 #include "background_manager.hpp"
@@ -25,55 +29,37 @@
 #include "srl_tilemap_interfaces.hpp"
 #include "camera_rig.hpp"
 
-#include <vector>
-
-#include <array>
-
-
-
-using namespace SRL::Types;
-
-using namespace SRL::Math::Types;
-
+#include "camera_chase.hpp"
 
+#include "track_collision.hpp"
 
-// Simple shading table
+#include "track_renderer.hpp"
 
-HighColor shadingTable[32] = {
+#include "blob_shadow.hpp"
 
-    HighColor::FromRGB555(0, 0, 0), HighColor::FromRGB555(1, 1, 1),
+#include "lighting_presets.hpp"
 
-    HighColor::FromRGB555(2, 2, 2), HighColor::FromRGB555(3, 3, 3),
+#include "frame_governor.hpp"
 
-    HighColor::FromRGB555(4, 4, 4), HighColor::FromRGB555(5, 5, 5),
+#include "video_mode.hpp"
 
-    HighColor::FromRGB555(6, 6, 6), HighColor::FromRGB555(7, 7, 7),
+#include "split_screen.hpp"
 
-    HighColor::FromRGB555(8, 8, 8), HighColor::FromRGB555(9, 9, 9),
-
-    HighColor::FromRGB555(10, 10, 10), HighColor::FromRGB555(11, 11, 11),
-
-    HighColor::FromRGB555(12, 12, 12), HighColor::FromRGB555(13, 13, 13),
-
-    HighColor::FromRGB555(14, 14, 14), HighColor::FromRGB555(15, 15, 15),
+#include <vector>
 
-    HighColor::FromRGB555(16, 16, 16), HighColor::FromRGB555(17, 17, 17),
+#include <array>
 
-    HighColor::FromRGB555(18, 18, 18), HighColor::FromRGB555(19, 19, 19),
 
-    HighColor::FromRGB555(20, 20, 20), HighColor::FromRGB555(21, 21, 21),
 
-    HighColor::FromRGB555(22, 22, 22), HighColor::FromRGB555(23, 23, 23),
+using namespace SRL::Types;
 
-    HighColor::FromRGB555(24, 24, 24), HighColor::FromRGB555(25, 25, 25),
+using namespace SRL::Math::Types;
 
-    HighColor::FromRGB555(26, 26, 26), HighColor::FromRGB555(27, 27, 27),
 
-    HighColor::FromRGB555(28, 28, 28), HighColor::FromRGB555(29, 29, 29),
 
-    HighColor::FromRGB555(30, 30, 30), HighColor::FromRGB555(31, 31, 31)
+// Luz do carro por clima/cobertura (tabela de gouraud ativa)
 
-};
+LightingPresets lighting;
 
 
 
@@ -85,10 +71,22 @@ int main()
 
     SRL::Debug::Print(1, 1, "CAR1.NYA viewer");
 
+    // Le o diretorio do CD uma unica vez (raiz + ARQ_TGA)
+    CdDirectory::Init();
+
 
 
     ModelObject car("CAR1.NYA", 0);
 
+    // Pista: gouraud logo apos as faces do carro; segmentos desenhados na ordem do INTLAGOS.MST
+    ModelObject track("INTLAGOS.NYA", car.GetFaceCount());
+    TrackCollision trackCollision;
+    trackCollision.Build(track);
+    TrackRenderer trackRenderer(track);
+    const char* trackOrderPaths[] = {"INTLAGOS.MST"};
+    const char* trackMapPaths[] = {"INTLAGOS.MAP"};
+    uint32_t trackFaceCount = track.GetFaceCount(); // antes do Load: faces que viram sprite mantem o indice de gouraud
+
     bool isSmoothMesh = car.IsSmooth();
 
     uint32_t faceCount = car.GetFaceCount();
@@ -97,8 +95,6 @@ int main()
 
     uint32_t meshCount = car.GetMeshCount();
 
-    SRL::Debug::Print(1, 2, "Faces:%u Verts:%u Meshes:%u Smooth:%d", faceCount, vertexCount, meshCount, isSmoothMesh ? 1 : 0);
-
 
 
     // Simple frustum
@@ -109,11 +105,16 @@ int main()
 
     // Sky via VDP2 (componente reutilizvel)
 
-    SRL::VDP2::SetBackColor(HighColor::FromRGB555(0, 0, 31)); // fallback azul
+    const uint8_t backColor[3] = {0, 0, 31}; // fallback azul; a neblina da pista tende a ela
 
+    SRL::VDP2::SetBackColor(HighColor::FromRGB555(backColor[0], backColor[1], backColor[2]));
 
 
-            BackgroundManager bgManager;    const char* skyPaths[] = {"cd/data/skybox_1.tga","data/skybox_1.tga","skybox_1.tga","cd/data/SKYBOX_1.TGA","data/SKYBOX_1.TGA","SKYBOX_1.TGA"};    bgManager.Init(skyPaths, sizeof(skyPaths) / sizeof(skyPaths[0]));
+
+            BackgroundManager bgManager;    const char* skyPaths[] = {"cd/data/skybox_1.tga","data/skybox_1.tga","skybox_1.tga","cd/data/SKYBOX_1.TGA","data/SKYBOX_1.TGA","SKYBOX_1.TGA"};    const char* groundPaths[] = {"ARQ_TGA/grama-verde-foto_64.tga","ARQ_TGA/grama_lateral_64.tga"};    bgManager.Init(skyPaths, sizeof(skyPaths) / sizeof(skyPaths[0]), groundPaths, sizeof(groundPaths) / sizeof(groundPaths[0]));
+    // Depois do chao: com o RBG0 carregado a grama plana sai da pista
+    trackRenderer.Load(trackOrderPaths, 1, trackMapPaths, 1, bgManager.env.useGround && bgManager.env.ground.loaded);
+    Scratchpad::Init(); // depois do load: o escravo comeca com o cache limpo
 
 
 
@@ -149,7 +150,7 @@ int main()
 
     Camera::RefreshAngles(cameraState);
 
-    cameraState.location = Camera::OrbitPosition(cameraState.yaw, cameraState.pitch, cameraState.radius) + cameraState.strafe;
+    Camera::RecalcPosition(cameraState);
 
 
 
@@ -169,13 +170,23 @@ int main()
 
     {
 
-        workTable.resize(faceCount << 2);
+        // Tabela cobre carro + pista (a pista comeca em car.GetFaceCount())
+
+        uint32_t litFaces = faceCount + trackFaceCount + DepthFog::Levels + NearSubdivision::MaxExtraFaces; // neblina e pedacos no fim
 
-        vertWork.resize(vertexCount);
+        workTable.resize(litFaces << 2);
 
-        SRL::Scene3D::LightInitGouraudTable(0, vertWork.data(), workTable.data(), faceCount);
+        vertWork.resize(vertexCount + track.GetVertexCount());
 
-        SRL::Scene3D::LightSetGouraudTable(shadingTable);
+        SRL::Scene3D::LightInitGouraudTable(0, vertWork.data(), workTable.data(), litFaces);
+
+        lighting.Init(LightingPresets::Preset::Skybox1);
+
+        SRL::Scene3D::LightSetGouraudTable(lighting.active);
+
+        trackRenderer.fog.Init(workTable.data(), (uint16_t)(faceCount + trackFaceCount), backColor);
+
+        trackRenderer.near.Init((uint16_t)(faceCount + trackFaceCount + DepthFog::Levels));
 
         SRL::Core::OnVblank += SRL::Scene3D::LightCopyGouraudTable;
 
@@ -189,8 +200,6 @@ int main()
 
     Vector3D modelOffset(-modelCenter.X, -modelCenter.Y, -modelCenter.Z);
 
-    SRL::Debug::Print(1, 3, "Center: %d, %d, %d", modelCenter.X.As<int16_t>(), modelCenter.Y.As<int16_t>(), modelCenter.Z.As<int16_t>());
-
 
 
     // Draw order: wheels first (1..4), then body (0)
@@ -210,6 +219,8 @@ int main()
     SRL::Input::Digital pad(0);
 
     int32_t carYawDeg = 0;
+    SRL::Input::Digital pad2(1); // jogador 2: Start no controle 2 liga a tela dividida
+    int32_t carYawDeg2 = 0;
 
 
 
@@ -247,25 +258,62 @@ int main()
 
     }
 
-    SRL::Debug::Print(1, 6, "Min: %d %d %d", minV.X.As<int16_t>(), minV.Y.As<int16_t>(), minV.Z.As<int16_t>());
 
-    SRL::Debug::Print(1, 7, "Max: %d %d %d", maxV.X.As<int16_t>(), maxV.Y.As<int16_t>(), maxV.Z.As<int16_t>());
 
-    SRL::Debug::Print(1, 9, "Model pos: %d %d %d", modelCenter.X.As<int16_t>(), modelCenter.Y.As<int16_t>(), modelCenter.Z.As<int16_t>());
+    HudStats hudStats;
 
+    hudStats.Init(faceCount, vertexCount, meshCount, isSmoothMesh, modelCenter, minV, maxV);
 
+    hudStats.MemoryReport();
 
-    HudStats hudStats;
+    // Sombra: pegada do modelo do carro, um quad por carro
+    BlobShadow blobShadow;
+    blobShadow.Init(minV, maxV);
 
-    hudStats.Init(faceCount, vertexCount, meshCount, isSmoothMesh, modelCenter, minV, maxV);
+    RaceHud raceHud(hudStats.text);
+    raceHud.Init();
+    RaceHud::Telemetry telemetry{};
 
     CameraRig::OrbitState xOrbitState{};
 
+    // Camera de perseguicao: A alterna Orbit/Chase/Bumper/Hood (carro parado na origem ate existir fisica)
+    Camera::Chase chaseCamera{};
+    Camera::ChaseTuning chaseTuning{};
+    const Vector3D carPosition(0.0, 0.0, 0.0);
+
+    // Ceus alternados com Start (hora do dia/clima)
+    const char* skyCycle[] = {"skybox_1.tga", "skybox_3.tga", "skybox_4.tga", "skybox_5.tga", "ceu.tga"};
+    const LightingPresets::Preset skyLighting[] = {
+        LightingPresets::Preset::Skybox1, LightingPresets::Preset::Skybox3, LightingPresets::Preset::Skybox4,
+        LightingPresets::Preset::Skybox5, LightingPresets::Preset::Ceu};
+    size_t skyIndex = 0;
+
+    // Ritmo 60/30 Hz e vies de detalhe da pista pelo custo medido
+    FrameGovernor governor;
+    governor.Init();
+
+    // Y fora da orbita: 320x224 <-> 320x448i
+    VideoMode videoMode;
+    Vector3D chaseLook;
+
+    // Tela dividida: Start no controle 2 alterna Single/Stacked/SideBySide; o jogador 2 so tem vistas de perseguicao
+    SplitScreen split;
+    Camera::State cameraState2 = cameraState;
+    Camera::Chase chaseCamera2{.view = Camera::View::Chase};
+    const Vector3D carPosition2(16.0, 0.0, 0.0);
+    Vector3D chaseLook2;
+
     while (1)
 
     {
 
-        Camera::UpdateInput(cameraState, cameraTuning, pad);
+        const uint8_t ticks = governor.BeginFrame();
+        trackRenderer.SetDetail(governor.bias + (split.Active() ? SplitScreen::SplitBias : 0));
+
+        if (pad.WasPressed(SRL::Input::Digital::Button::A)) Camera::NextView(chaseCamera, cameraState);
+        const bool orbitView = chaseCamera.view == Camera::View::Orbit;
+
+        if (orbitView) Camera::UpdateInput(cameraState, cameraTuning, pad);
 
         const bool aHeld = pad.IsHeld(SRL::Input::Digital::Button::A);
 
@@ -281,58 +329,113 @@ int main()
 
 
 
-        // Rotaciona apenas o carro com L/R (plano horizontal)
-
-        if (!aHeld && !bHeld && !cHeld)
+        // Controles de rodas: C inicia/resume, B para
+        if (cHeld) { carRenderer.StartAllWheels(Angle::FromDegrees(SRL::Math::Types::Fxp::Convert(15))); carRenderer.ResumeAllWheels(); }
+        if (bHeld) { carRenderer.StopAllWheels(); }
 
+        // Simulacao em ticks de 60 Hz: a 30 Hz roda dois por frame e a velocidade do jogo nao muda
+        for (uint8_t tick = 0; tick < ticks; ++tick)
         {
-
-            if (lHeld) carYawDeg -= carYawStepDeg;
-
-            if (rHeld) carYawDeg += carYawStepDeg;
-
-            if (carYawDeg < 0) carYawDeg += 360;
-
-            if (carYawDeg >= 360) carYawDeg -= 360;
-
+            // Rotaciona apenas o carro com L/R (plano horizontal)
+            if (!aHeld && !bHeld && !cHeld)
+            {
+                if (lHeld) carYawDeg -= carYawStepDeg;
+                if (rHeld) carYawDeg += carYawStepDeg;
+                if (carYawDeg < 0) carYawDeg += 360;
+                if (carYawDeg >= 360) carYawDeg -= 360;
+            }
+
+            // Rotaciona carro e camera (modo X) usando CameraRig utilit?rio
+            if (orbitView) CameraRig::HandleOrbitAroundCar(cameraState, carYawStepDeg, xHeld, lHeld, rHeld, carYawDeg, xOrbitState, true);
+            else chaseLook = Camera::UpdateChase(chaseCamera, cameraState, chaseTuning, carPosition, carYawDeg, &trackCollision);
+
+            carRenderer.Advance();
+
+            if (split.Active())
+            {
+                if (pad2.IsHeld(SRL::Input::Digital::Button::L)) carYawDeg2 -= carYawStepDeg;
+                if (pad2.IsHeld(SRL::Input::Digital::Button::R)) carYawDeg2 += carYawStepDeg;
+                if (carYawDeg2 < 0) carYawDeg2 += 360;
+                if (carYawDeg2 >= 360) carYawDeg2 -= 360;
+                chaseLook2 = Camera::UpdateChase(chaseCamera2, cameraState2, chaseTuning, carPosition2, carYawDeg2, &trackCollision);
+            }
         }
 
+        if (split.Active() && pad2.WasPressed(SRL::Input::Digital::Button::A))
+        {
+            Camera::NextView(chaseCamera2, cameraState2);
+            if (chaseCamera2.view == Camera::View::Orbit) Camera::NextView(chaseCamera2, cameraState2);
+        }
 
+        // Troca de arranjo; com uma troca de ceu em andamento fica para o proximo Start
+        if (pad2.WasPressed(SRL::Input::Digital::Button::START))
+        {
+            SplitScreen::Layout previous = split.layout;
+            split.Next();
+            if (bgManager.SetSplit(split.Active(), split.SkySecondLine(), split.SkyRowOffset(0)))
+            {
+                split.ApplyBackground(videoMode);
+            }
+            else
+            {
+                split.layout = previous;
+            }
+        }
 
-        // Rotaciona carro e camera (modo X) usando CameraRig utilit?rio
-        CameraRig::HandleOrbitAroundCar(cameraState, carYawStepDeg, xHeld, lHeld, rHeld, carYawDeg, xOrbitState, true);
+        if (pad.WasPressed(SRL::Input::Digital::Button::START) && !bgManager.switcher.IsBusy())
+        {
+            size_t next = (skyIndex + 1) % (sizeof(skyCycle) / sizeof(skyCycle[0]));
+            if (bgManager.RequestSky(&skyCycle[next], 1))
+            {
+                skyIndex = next;
+                lighting.SetBase(skyLighting[skyIndex]);
+            }
+        }
 
-        // Controles de rodas: C inicia/resume, B para
-        if (cHeld) { carRenderer.StartAllWheels(Angle::FromDegrees(SRL::Math::Types::Fxp::Convert(15))); carRenderer.ResumeAllWheels(); }
-        if (bHeld) { carRenderer.StopAllWheels(); }
+        if (!orbitView && pad.WasPressed(SRL::Input::Digital::Button::Y) && videoMode.Toggle())
+        {
+            hudStats.text.SetTall(videoMode.doubled);
+            bgManager.SetLineDoubling(videoMode.doubled);
+            trackRenderer.sprites.tallPixels = videoMode.doubled;
+            split.ApplyBackground(videoMode);
+        }
 
 // Atualiza skybox VDP2
+        bgManager.UpdateSecond(cameraState2, split.SkyRowOffset(1));
         bgManager.Update(cameraState);
 
         Vector3D cameraLocation = cameraState.location;
-        Vector3D lookTarget = Camera::ComputeLookTarget(cameraState, cameraTuning, pad, modelCenter);
+        Vector3D lookTarget = orbitView ? Camera::ComputeLookTarget(cameraState, cameraTuning, pad, modelCenter) : chaseLook;
+        trackRenderer.culling.useSlave = !bgManager.switcher.SlaveBusy();
+        trackRenderer.BeginView(0);
+        trackRenderer.Prepare(carPosition, cameraLocation, lookTarget);
+        lighting.Update(trackRenderer.CarCovered());
         // lookTarget padrao segue o alvo calculado (b livre)
         hudStats.Update(cameraState, modelOffset, cameraLocation, modelCenter);
 
+        // Sem fisica ainda: velocidade pelo giro das rodas (pneu ~1,9 m), um giro por tick de 60 Hz
+        int32_t wheelRaw = (int16_t)carRenderer.WheelStep().RawValue();
+        telemetry.speedKmh = ((wheelRaw < 0 ? -wheelRaw : wheelRaw) * 410) >> 16;
+        telemetry.gear = (uint8_t)(telemetry.speedKmh < 250 ? 1 + telemetry.speedKmh / 50 : 6);
+        telemetry.rpm = 1000 + (telemetry.speedKmh - (telemetry.gear - 1) * 50) * 160;
+        if (telemetry.speedKmh > 0) telemetry.lapTicks += ticks;
+        raceHud.Tick(telemetry);
+
+        if (split.Active()) split.Begin(0, videoMode);
         SRL::Scene3D::LoadIdentity();
+        videoMode.Apply();
         SRL::Scene3D::LookAt(cameraLocation, lookTarget, Angle::FromDegrees(0.0));
-        // Debug: posicoes das rodas
-                const auto& centers = carRenderer.MeshCenters();
-        if (centers.size() > 4)
-        {
-            SRL::Debug::Print(1, 10, "Roda_1: %d %d %d", centers[1].X.As<int16_t>(), centers[1].Y.As<int16_t>(), centers[1].Z.As<int16_t>());
-            SRL::Debug::Print(1, 11, "Roda_2: %d %d %d", centers[2].X.As<int16_t>(), centers[2].Y.As<int16_t>(), centers[2].Z.As<int16_t>());
-            auto r3pivot = centers[3] - modelCenter;
-            SRL::Debug::Print(1, 12, "Roda_3: %d %d %d", centers[3].X.As<int16_t>(), centers[3].Y.As<int16_t>(), centers[3].Z.As<int16_t>());
-            SRL::Debug::Print(1, 13, "R3 piv: %d %d %d", r3pivot.X.As<int16_t>(), r3pivot.Y.As<int16_t>(), r3pivot.Z.As<int16_t>());
-            SRL::Debug::Print(1, 14, "Roda_4: %d %d %d", centers[4].X.As<int16_t>(), centers[4].Y.As<int16_t>(), centers[4].Z.As<int16_t>());
-        }
-        SRL::Debug::Print(1, 4, "Offset: %d, %d, %d", modelOffset.X.As<int16_t>(), modelOffset.Y.As<int16_t>(), modelOffset.Z.As<int16_t>());
-        SRL::Debug::Print(1, 5, "Cam: %d, %d, %d", cameraLocation.X.As<int16_t>(), cameraLocation.Y.As<int16_t>(), cameraLocation.Z.As<int16_t>());
-        SRL::Debug::Print(1, 8, "Yaw:%u Pitch:%u R:%d", cameraState.yaw.RawValue(), cameraState.pitch.RawValue(), cameraState.radius.As<int16_t>());
+        hudStats.UpdateWheels(carRenderer.MeshCenters(), modelCenter);
+        trackRenderer.Render(lightDirection);
+        blobShadow.Draw(trackCollision, carPosition, carYawDeg);
         carRenderer.rotY = Angle::FromDegrees(Fxp::Convert(carYawDeg));
         // roda gira constante (ajuste se necessario)
         carRenderer.Render();
+        if (split.Active())
+        {
+            blobShadow.Draw(trackCollision, carPosition2, carYawDeg2);
+            carRenderer.RenderAt(carPosition2, carYawDeg2);
+        }
 
         // Draw axis lines at the origin for reference
         Vector2D o2D, x2D, y2D, z2D;
@@ -344,6 +447,24 @@ int main()
         SRL::Scene2D::DrawLine(o2D, x2D, HighColor::Colors::Red, sort2D);
         SRL::Scene2D::DrawLine(o2D, y2D, HighColor::Colors::Green, sort2D);
         SRL::Scene2D::DrawLine(o2D, z2D, HighColor::Colors::Blue, sort2D);
+
+        // Segundo viewport: mesma pista e mesmo carro, culling refeito pela camera do jogador 2
+        if (split.Active())
+        {
+            trackRenderer.BeginView(1);
+            trackRenderer.Prepare(carPosition2, cameraState2.location, chaseLook2);
+            split.Begin(1, videoMode);
+            SRL::Scene3D::LoadIdentity();
+            videoMode.Apply();
+            SRL::Scene3D::LookAt(cameraState2.location, chaseLook2, Angle::FromDegrees(0.0));
+            trackRenderer.Render(lightDirection);
+            blobShadow.Draw(trackCollision, carPosition, carYawDeg);
+            blobShadow.Draw(trackCollision, carPosition2, carYawDeg2);
+            carRenderer.RenderAt(carPosition, carYawDeg);
+            carRenderer.RenderAt(carPosition2, carYawDeg2);
+            split.End(videoMode);
+        }
+        governor.EndFrame();
         SRL::Core::Synchronize();
 
     }
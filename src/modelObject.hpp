@@ -1,6 +1,9 @@
 #pragma once
 
 #include <srl.hpp>
+#include "cd_directory.hpp"
+#include "texture_cache.hpp"
+#include "work_ram.hpp"
 
 /** @brief Detect whether object has size function
  * @tparam T Object type
@@ -163,6 +166,18 @@ private:
      */
     size_t textureCount;
 
+    /** @brief VDP1 slot of each texture in the file (identical images share a slot)
+     */
+    uint16_t* textureSlots = nullptr;
+
+    /** @brief File offset of each texture header, for reading pixels back after load
+     */
+    uint32_t* textureOffsets = nullptr;
+
+    /** @brief Resolved path of the model file
+     */
+    const char* filePath = nullptr;
+
     /** @brief Mesh type
      */
     uint32_t type;
@@ -286,6 +301,39 @@ private:
         ((SRL::Types::SmoothMesh*)this->meshes)[entryId] = std::move(mesh);
     }
 
+    /** @brief Point face attributes at the shared texture slots
+     * @param firstSlot Slot the meshes assumed for the first texture of the file
+     */
+    void RemapTextures(uint16_t firstSlot)
+    {
+        for (size_t mesh = 0; mesh < this->meshCount; mesh++)
+        {
+            SRL::Types::Attribute* attributes;
+            size_t faceCount;
+
+            if (this->type == 1)
+            {
+                attributes = ((SRL::Types::SmoothMesh*)this->meshes)[mesh].Attributes;
+                faceCount = ((SRL::Types::SmoothMesh*)this->meshes)[mesh].FaceCount;
+            }
+            else
+            {
+                attributes = ((SRL::Types::Mesh*)this->meshes)[mesh].Attributes;
+                faceCount = ((SRL::Types::Mesh*)this->meshes)[mesh].FaceCount;
+            }
+
+            for (size_t face = 0; face < faceCount; face++)
+            {
+                // Same layout as SGL ATTR
+                ATTR* attribute = (ATTR*)&attributes[face];
+                if (attribute->texno == No_Texture || attribute->texno < firstSlot) continue;
+
+                size_t textureIndex = attribute->texno - firstSlot;
+                if (textureIndex < this->textureCount) attribute->texno = this->textureSlots[textureIndex];
+            }
+        }
+    }
+
 public:
 
     /** @brief Initializes a new model object from a file
@@ -294,9 +342,10 @@ public:
      */
     ModelObject(const char* modelFile, size_t gouraudTableStart = 0)
     {
-        SRL::Cd::File file = SRL::Cd::File(modelFile);
+        const char* modelPath = CdDirectory::ResolvePath(&modelFile, 1);
+        SRL::Cd::File file = SRL::Cd::File(modelPath != nullptr ? modelPath : modelFile);
 
-        if (!file.Exists() || file.Size.Bytes <= 0)
+        if (modelPath == nullptr || file.Size.Bytes <= 0)
         {
             SRL::Debug::Print(1, 6, "NYA not found: %s", modelFile);
             this->meshes = nullptr;
@@ -308,11 +357,12 @@ public:
             return;
         }
 
-        char* fileBuffer = new char[file.Size.Bytes];
-        if (file.LoadBytes(0, file.Size.Bytes, fileBuffer) <= 0)
+        // File is only parsed once, meshes are copied out of it into the default (HWRAM) heap
+        char* fileBuffer = (char*)WorkRam::Allocate("nya file", WorkRam::Region::Low, file.Size.Bytes);
+        if (fileBuffer == nullptr || file.LoadBytes(0, file.Size.Bytes, fileBuffer) <= 0)
         {
             SRL::Debug::Print(1, 6, "NYA read fail: %s", modelFile);
-            delete[] fileBuffer;
+            WorkRam::Free(fileBuffer);
             this->meshes = nullptr;
             this->meshCount = 0;
             this->textureCount = 0;
@@ -351,24 +401,39 @@ public:
             }
         }
 
-        // Load textures
+        // Load textures, meshes were built expecting them in consecutive slots from here
+        uint16_t expectedSlot = SRL::VDP1::GetTextureCount();
+        bool remapNeeded = false;
+        this->textureSlots = this->textureCount > 0 ? new uint16_t[this->textureCount] : nullptr;
+        this->textureOffsets = this->textureCount > 0 ? new uint32_t[this->textureCount] : nullptr;
+        this->filePath = modelPath;
+
         for (size_t textureIndex = 0; textureIndex < this->textureCount; textureIndex++)
         {
             // Get header
+            this->textureOffsets[textureIndex] = (uint32_t)(iterator - fileBuffer);
             TextureHeader* textureHeader = GetAndIterate<TextureHeader>(iterator);
 
-            // Get texture data
-            int32_t spriteIndex = SRL::VDP1::TryLoadTexture(textureHeader->Width, textureHeader->Height, SRL::CRAM::TextureColorMode::RGB555, 0, textureHeader->Data());
+            // Get texture data, uploaded only if no identical image is in VDP1 yet
+            int32_t spriteIndex = TextureCache::Load(textureHeader->Width, textureHeader->Height, textureHeader->Data());
+            this->textureSlots[textureIndex] = spriteIndex >= 0 ? (uint16_t)spriteIndex : (uint16_t)No_Texture;
+            remapNeeded |= this->textureSlots[textureIndex] != expectedSlot + textureIndex;
         }
 
+        if (this->textureCount > 0) this->startTextureIndex = this->textureSlots[0];
+        if (remapNeeded) this->RemapTextures(expectedSlot);
+
         // Free the read file
-        delete[] fileBuffer;
+        WorkRam::Free(fileBuffer);
     }
 
     /** @brief Destroy the Model object and free its resources, textures must be freed separately
      */
     ~ModelObject()
     {
+        delete[] this->textureSlots;
+        delete[] this->textureOffsets;
+
         if (this->type == 0)
         {
             delete[] (SRL::Types::Mesh*)this->meshes;
@@ -461,6 +526,44 @@ public:
         return this->startTextureIndex;
     }
 
+    /** @brief Get the VDP1 slot of a texture from the model file
+     * @param textureIndex Texture index inside the file
+     * @return Texture slot or No_Texture
+     */
+    uint16_t GetTextureSlot(size_t textureIndex) const
+    {
+        return textureIndex < this->textureCount && this->textureSlots != nullptr ? this->textureSlots[textureIndex] : (uint16_t)No_Texture;
+    }
+
+    /** @brief Read pixels of a texture back from the model file
+     * @note Pixels are not kept in work RAM after upload, so this reads the CD again (load time only)
+     * @param textureIndex Texture index inside the file
+     * @param width Texture width
+     * @param height Texture height
+     * @return Pixels in a low work RAM buffer (release with WorkRam::Free) or nullptr
+     */
+    SRL::Types::HighColor* ReadTexture(size_t textureIndex, uint16_t& width, uint16_t& height) const
+    {
+        if (this->filePath == nullptr || this->textureOffsets == nullptr || textureIndex >= this->textureCount) return nullptr;
+
+        SRL::Cd::File file = SRL::Cd::File(this->filePath);
+        TextureHeader header;
+        uint32_t offset = this->textureOffsets[textureIndex];
+        if (file.LoadBytes(offset, sizeof(TextureHeader), &header) <= 0) return nullptr;
+
+        uint32_t bytes = sizeof(SRL::Types::HighColor) * header.Width * header.Height;
+        SRL::Types::HighColor* pixels = (SRL::Types::HighColor*)WorkRam::Allocate("texture read", WorkRam::Region::Low, bytes);
+        if (pixels == nullptr || file.LoadBytes(offset + sizeof(TextureHeader), bytes, pixels) <= 0)
+        {
+            WorkRam::Free(pixels);
+            return nullptr;
+        }
+
+        width = header.Width;
+        height = header.Height;
+        return pixels;
+    }
+
     /** @brief Get the mesh data
      * @tparam ReturnValue SRL::Types::Mesh or SRL::Types::SmoothMesh
      * @param id Mesh id
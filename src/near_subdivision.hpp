@@ -0,0 +1,376 @@
+#pragma once
+
+#include <srl.hpp>
+#include <vector>
+#include "modelObject.hpp"
+#include "texture_cache.hpp"
+#include "work_ram.hpp"
+
+// Faces grandes perto da camera: divididas em 2x2 ou 4x4 e cortadas no plano near antes do SGL.
+// Uma face so e dividida quando o olho esta mais perto dela que o proprio tamanho (2x2) ou metade (4x4);
+// cada pedaco usa o recorte da textura feito no load, entao o mapeamento nao muda e a VDP1 desenha
+// quads pequenos e pouco distorcidos. Vertices atras do near sao puxados pelas arestas ate o plano, em vez
+// de serem projetados atras da camera. Vertices, faces e entradas de gouraud saem de orcamentos fixos:
+// sem espaco, a face volta a ser desenhada inteira.
+struct NearSubdivision
+{
+    static constexpr uint8_t MaxLevel = 2;            // 1 = 2x2, 2 = 4x4
+    static constexpr size_t MaxPieces = 16;
+    static constexpr uint16_t MaxExtraFaces = 384;    // por frame; tambem o bloco de gouraud reservado
+    static constexpr uint16_t MaxExtraVertices = 768;
+    static constexpr uint16_t GouraudBase = 0xe000;
+    static constexpr uint16_t NoVertex = 0xffff;
+    static constexpr uint8_t FlipH = 1 << 4;          // bits de inversao de ATTR.dir
+    static constexpr uint8_t FlipV = 1 << 5;
+
+    struct Config
+    {
+        int32_t nearDistance = 0x18000;  // plano 1.5 unidade a frente do olho
+        int32_t minSplitSize = 16 << 16; // aresta (L1) abaixo disso: so corte, sem divisao
+    };
+
+    // Recortes de uma textura, linha por linha: pieces[0] = 2x2, pieces[1] = 4x4
+    struct Split
+    {
+        uint16_t texture;
+        uint8_t levels;
+        uint16_t pieces[MaxLevel][MaxPieces];
+    };
+
+    // Lista compacta da malha sendo montada em FaceCulling::Draw
+    struct Output
+    {
+        SRL::Math::Types::Vector3D* points;
+        SRL::Math::Types::Vector3D* normals;
+        POLYGON* polygons;
+        ATTR* attributes;
+        uint32_t vertexCount;
+        uint32_t faceCount;
+    };
+
+    Config config;
+    std::vector<Split> splits;
+    int32_t eye[3] = {};
+    int32_t forward[3] = {0, 0, 0x10000};
+    uint16_t gouraudFirst = 0;
+    uint16_t gouraudUsed = 0;
+    uint32_t extraVertices = 0; // tudo que Emit escreve conta aqui: a lista compacta tem essa folga
+    uint32_t extraFaces = 0;
+    uint32_t splitFaces = 0;   // estatisticas do frame
+    uint32_t clippedFaces = 0;
+    uint32_t droppedFaces = 0;
+    bool enabled = false;
+
+    static int32_t Dot(const int32_t* a, const int32_t* b)
+    {
+        return (int32_t)(((int64_t)a[0] * b[0] + (int64_t)a[1] * b[1] + (int64_t)a[2] * b[2]) >> 16);
+    }
+
+    static int32_t Abs(int32_t value)
+    {
+        return value < 0 ? -value : value;
+    }
+
+    static int32_t L1(const int32_t* a, const int32_t* b)
+    {
+        return Abs(a[0] - b[0]) + Abs(a[1] - b[1]) + Abs(a[2] - b[2]);
+    }
+
+    // |v| em 16.16 (uma vez por frame)
+    static int32_t Length(const int32_t* v)
+    {
+        uint64_t value = (uint64_t)((int64_t)v[0] * v[0]) + (uint64_t)((int64_t)v[1] * v[1]) + (uint64_t)((int64_t)v[2] * v[2]);
+        uint64_t result = 0;
+        for (uint64_t bit = 1ull << 62; bit != 0; bit >>= 2)
+        {
+            if (value >= result + bit)
+            {
+                value -= result + bit;
+                result = (result >> 1) + bit;
+            }
+            else
+            {
+                result >>= 1;
+            }
+        }
+        return (int32_t)result;
+    }
+
+    /** @brief Recorta uma textura do modelo em 2x2 e 4x4 pedacos e envia para a VDP1
+     * @note Le os pixels de novo do CD (so no load)
+     */
+    WORKRAM_COLD bool AddTexture(const ModelObject& model, size_t textureIndex)
+    {
+        uint16_t width = 0, height = 0;
+        SRL::Types::HighColor* pixels = model.ReadTexture(textureIndex, width, height);
+        if (pixels == nullptr) return false;
+
+        Split split = {};
+        split.texture = model.GetTextureSlot(textureIndex);
+        SRL::Types::HighColor* piece = (SRL::Types::HighColor*)WorkRam::Allocate("texture piece", WorkRam::Region::Low, sizeof(SRL::Types::HighColor) * (width / 2) * (height / 2));
+
+        for (uint8_t level = 0; level < MaxLevel && piece != nullptr && split.texture != No_Texture; ++level)
+        {
+            uint16_t n = 2 << level;
+            uint16_t pieceWidth = width / n, pieceHeight = height / n;
+            if (pieceWidth == 0 || pieceWidth % 8 != 0 || pieceHeight == 0) break; // VDP1: largura multipla de 8
+
+            bool loaded = true;
+            for (uint16_t row = 0; row < n && loaded; ++row)
+            {
+                for (uint16_t col = 0; col < n && loaded; ++col)
+                {
+                    for (uint16_t y = 0; y < pieceHeight; ++y)
+                    {
+                        const SRL::Types::HighColor* source = &pixels[(row * pieceHeight + y) * width + col * pieceWidth];
+                        for (uint16_t x = 0; x < pieceWidth; ++x) piece[y * pieceWidth + x] = source[x];
+                    }
+
+                    int32_t slot = TextureCache::Load(pieceWidth, pieceHeight, piece);
+                    loaded = slot >= 0;
+                    split.pieces[level][row * n + col] = loaded ? (uint16_t)slot : (uint16_t)No_Texture;
+                }
+            }
+            if (!loaded) break;
+            split.levels = level + 1;
+        }
+
+        WorkRam::Free(piece);
+        WorkRam::Free(pixels);
+        if (split.levels == 0) return false;
+
+        splits.push_back(split);
+        return true;
+    }
+
+    /** @brief Liga o modulo com um bloco proprio na tabela de gouraud
+     * @param entry Primeira de MaxExtraFaces entradas livres
+     */
+    void Init(uint16_t entry)
+    {
+        gouraudFirst = entry;
+        enabled = true;
+    }
+
+    /** @brief Olho e direcao de visao no espaco do modelo
+     */
+    WORKRAM_HOT void BeginFrame(const int32_t* eyeModel, const int32_t* targetModel)
+    {
+        int32_t view[3];
+        for (size_t k = 0; k < 3; ++k)
+        {
+            eye[k] = eyeModel[k];
+            view[k] = targetModel[k] - eyeModel[k];
+        }
+
+        int32_t length = Length(view);
+        if (length > 0)
+        {
+            for (size_t k = 0; k < 3; ++k) forward[k] = (int32_t)(((int64_t)view[k] << 16) / length);
+        }
+
+        gouraudUsed = 0;
+        extraVertices = 0;
+        extraFaces = 0;
+        splitFaces = 0;
+        clippedFaces = 0;
+        droppedFaces = 0;
+    }
+
+    const Split* FindSplit(uint16_t texture) const
+    {
+        if (texture == No_Texture) return nullptr;
+        for (const Split& split : splits)
+        {
+            if (split.texture == texture) return &split;
+        }
+        return nullptr;
+    }
+
+    // Distancia com sinal ao plano near (negativa = atras)
+    int32_t NearSide(const int32_t* p) const
+    {
+        int32_t d[3] = {p[0] - eye[0], p[1] - eye[1], p[2] - eye[2]};
+        return Dot(forward, d) - config.nearDistance;
+    }
+
+    static void Raw(const SRL::Math::Types::Vector3D& v, int32_t* out)
+    {
+        out[0] = v.X.RawValue();
+        out[1] = v.Y.RawValue();
+        out[2] = v.Z.RawValue();
+    }
+
+    static SRL::Math::Types::Vector3D FromRaw(const int32_t* v)
+    {
+        using SRL::Math::Types::Fxp;
+        return SRL::Math::Types::Vector3D(Fxp::BuildRaw(v[0]), Fxp::BuildRaw(v[1]), Fxp::BuildRaw(v[2]));
+    }
+
+    // Ponto de i a caminho de j onde cruza o plano (s[i] < 0 <= s[j])
+    static void Cross(const int32_t* from, const int32_t* to, int32_t sFrom, int32_t sTo, int32_t* out)
+    {
+        int32_t t = (int32_t)(((int64_t)-sFrom << 16) / (sTo - sFrom));
+        for (size_t k = 0; k < 3; ++k) out[k] = from[k] + (int32_t)(((int64_t)(to[k] - from[k]) * t) >> 16);
+    }
+
+    // Vertice atras do plano: media dos cortes nas arestas com vizinhos na frente, ou na diagonal
+    static void Pull(const int32_t (*p)[3], const int32_t* s, size_t i, int32_t* out)
+    {
+        size_t neighbours[2] = {(i + 3) & 3, (i + 1) & 3};
+        int32_t sum[3] = {0, 0, 0};
+        int32_t hits = 0;
+        for (size_t j : neighbours)
+        {
+            if (s[j] < 0) continue;
+            int32_t cut[3];
+            Cross(p[i], p[j], s[i], s[j], cut);
+            for (size_t k = 0; k < 3; ++k) sum[k] += cut[k] / 2;
+            ++hits;
+        }
+
+        if (hits == 0)
+        {
+            size_t j = (i + 2) & 3;
+            Cross(p[i], p[j], s[i], s[j], out);
+            return;
+        }
+        for (size_t k = 0; k < 3; ++k) out[k] = hits == 2 ? sum[k] : sum[k] * 2;
+    }
+
+    uint32_t PushVertex(Output& out, const int32_t* position, const int32_t* normal)
+    {
+        out.points[out.vertexCount] = FromRaw(position);
+        out.normals[out.vertexCount] = FromRaw(normal);
+        return out.vertexCount++;
+    }
+
+    /** @brief Emite a face dividida e/ou cortada no near
+     * @return false se a face nao precisa de tratamento (o chamador a emite como sempre)
+     */
+    WORKRAM_HOT bool Emit(const SRL::Types::SmoothMesh& mesh, size_t face, Output& out)
+    {
+        const auto& polygon = mesh.Faces[face];
+        int32_t corner[4][3], cornerNormal[4][3], side[4];
+        bool anyBehind = false, allBehind = true;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            Raw(mesh.Vertices[polygon.Vertices[i]], corner[i]);
+            Raw(mesh.Normals[polygon.Vertices[i]], cornerNormal[i]);
+            side[i] = NearSide(corner[i]);
+            anyBehind |= side[i] < 0;
+            allBehind &= side[i] < 0;
+        }
+
+        if (allBehind)
+        {
+            droppedFaces++;
+            return true;
+        }
+
+        // Nivel pelo tamanho da face contra a distancia (L1) do olho ao centro
+        const ATTR& attribute = *(const ATTR*)&mesh.Attributes[face];
+        const Split* split = FindSplit(attribute.texno);
+        uint8_t level = 0;
+        int32_t size = L1(corner[0], corner[2]) / 2;
+        if (split != nullptr && size >= config.minSplitSize)
+        {
+            int32_t center[3];
+            for (size_t k = 0; k < 3; ++k) center[k] = corner[0][k] / 2 + corner[2][k] / 2;
+            int32_t distance = L1(center, eye);
+            if (distance < size) level = distance < size / 2 ? 2 : 1;
+            if (level > split->levels) level = split->levels;
+        }
+
+        // Orcamento: grade (n+1)^2 + 4 vertices proprios por pedaco cortado
+        uint16_t n = level == 0 ? 1 : 1 << level;
+        uint32_t needVertices = (n + 1) * (n + 1) + 4u * n * n;
+        bool fits = extraVertices + needVertices <= MaxExtraVertices && extraFaces + n * n <= MaxExtraFaces && gouraudUsed + n * n <= MaxExtraFaces;
+        if (level != 0 && !fits)
+        {
+            level = 0;
+            n = 1;
+            fits = extraVertices + 8 <= MaxExtraVertices && extraFaces < MaxExtraFaces;
+        }
+        if (level == 0 && (!anyBehind || !fits)) return false;
+
+        // Grade bilinear de posicoes, normais e lado do plano
+        constexpr size_t MaxGrid = ((1 << MaxLevel) + 1) * ((1 << MaxLevel) + 1);
+        int32_t grid[MaxGrid][3], gridNormal[MaxGrid][3], gridSide[MaxGrid];
+        uint16_t gridOut[MaxGrid];
+        int32_t area = n * n;
+        for (uint16_t r = 0; r <= n; ++r)
+        {
+            for (uint16_t c = 0; c <= n; ++c)
+            {
+                size_t g = r * (n + 1) + c;
+                int32_t w[4] = {(n - c) * (n - r), c * (n - r), c * r, (n - c) * r};
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    int64_t p = 0, q = 0;
+                    for (size_t i = 0; i < 4; ++i)
+                    {
+                        p += (int64_t)corner[i][k] * w[i];
+                        q += (int64_t)cornerNormal[i][k] * w[i];
+                    }
+                    grid[g][k] = (int32_t)(p / area);
+                    gridNormal[g][k] = (int32_t)(q / area);
+                }
+                gridSide[g] = NearSide(grid[g]);
+                gridOut[g] = NoVertex;
+            }
+        }
+
+        uint32_t firstVertex = out.vertexCount, firstFace = out.faceCount;
+        for (uint16_t r = 0; r < n; ++r)
+        {
+            for (uint16_t c = 0; c < n; ++c)
+            {
+                size_t g[4] = {(size_t)(r * (n + 1) + c), (size_t)(r * (n + 1) + c + 1), (size_t)((r + 1) * (n + 1) + c + 1), (size_t)((r + 1) * (n + 1) + c)};
+                int32_t p[4][3], s[4];
+                bool behind = false, hidden = true;
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    for (size_t k = 0; k < 3; ++k) p[i][k] = grid[g[i]][k];
+                    s[i] = gridSide[g[i]];
+                    behind |= s[i] < 0;
+                    hidden &= s[i] < 0;
+                }
+                if (hidden) continue;
+
+                POLYGON& target = out.polygons[out.faceCount];
+                target = *(const POLYGON*)&polygon;
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    if (s[i] < 0)
+                    {
+                        int32_t pulled[3];
+                        Pull(p, s, i, pulled);
+                        target.Vertices[i] = (uint16_t)PushVertex(out, pulled, gridNormal[g[i]]);
+                        continue;
+                    }
+                    if (gridOut[g[i]] == NoVertex) gridOut[g[i]] = (uint16_t)PushVertex(out, grid[g[i]], gridNormal[g[i]]);
+                    target.Vertices[i] = gridOut[g[i]];
+                }
+
+                ATTR& targetAttribute = out.attributes[out.faceCount];
+                targetAttribute = attribute;
+                if (level != 0)
+                {
+                    // Pedaco espelhado junto com a face; cada pedaco tem a sua entrada de gouraud
+                    uint16_t row = (attribute.dir & FlipV) ? n - 1 - r : r;
+                    uint16_t col = (attribute.dir & FlipH) ? n - 1 - c : c;
+                    targetAttribute.texno = split->pieces[level - 1][row * n + col];
+                    if (attribute.sort & UseGouraud) targetAttribute.gstb = GouraudBase + gouraudFirst + gouraudUsed++;
+                }
+                out.faceCount++;
+                if (behind) clippedFaces++;
+            }
+        }
+
+        extraVertices += out.vertexCount - firstVertex;
+        extraFaces += out.faceCount - firstFace;
+        if (level != 0) splitFaces++;
+        return true;
+    }
+};
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <srl.hpp>
+#include "hud_text.hpp"
+#include "vdp2_planner.hpp"
+
+// HUD de corrida inteiro no NBG2 (nenhum comando VDP1): velocimetro e conta-giros com
+// ponteiro animado por troca de celulas, mais marcha, volta, tempos e posicao em texto.
+struct RaceHud
+{
+    // Estado que a simulacao entrega a cada tick fixo
+    struct Telemetry
+    {
+        int32_t speedKmh = 0;
+        int32_t rpm = 0;
+        uint8_t gear = 1;
+        uint8_t lap = 1;
+        uint8_t lapCount = 1;
+        uint8_t position = 1;
+        uint8_t carCount = 1;
+        uint32_t lapTicks = 0;     // ticks de 60 Hz na volta atual
+        uint32_t bestLapTicks = 0; // 0 = sem volta completa
+    };
+
+    static constexpr uint8_t GaugeCells = 4;   // mostrador 4x4 celulas (32x32 px)
+    static constexpr uint8_t GaugePixels = GaugeCells * 8;
+    static constexpr uint8_t CellsPerFrame = GaugeCells * GaugeCells;
+    static constexpr uint8_t NeedleFrames = 16;
+    static constexpr int32_t SweepDeg = 270;    // de -135 a +135 graus, 0 = para cima
+    static constexpr int32_t MaxSpeedKmh = 320;
+    static constexpr int32_t MaxRpm = 10000;
+
+    struct Gauge
+    {
+        uint8_t column;
+        uint8_t row;
+        int32_t maxValue;
+        uint8_t frame = 0xff;
+    };
+
+    HudText& text;
+    uint8_t* needleCells = nullptr; // NeedleFrames quadros de CellsPerFrame celulas
+    bool ready = false;
+
+    Gauge speedGauge{1, 21, MaxSpeedKmh};
+    Gauge rpmGauge{6, 21, MaxRpm};
+    HudText::Field speed{1, 25, 3};
+    HudText::Field gear{8, 25, 1};
+    HudText::Field lap{34, 15, 2}, lapCount{37, 15, 2};
+    HudText::Field lapTime{33, 16, 7};
+    HudText::Field bestTime{33, 17, 7};
+    HudText::Field position{34, 18, 2}, carCount{37, 18, 2};
+
+    explicit RaceHud(HudText& hudText) : text(hudText) {}
+
+    /** @brief Desenha os quadros do ponteiro na VRAM e escreve os rotulos
+     * @note Chamar depois de HudText::Init
+     */
+    bool Init()
+    {
+        if (ready) return true;
+        if (!text.ready) return false;
+
+        // Mesmo NBG2 da fonte: os ciclos de leitura ja foram contados por HudText
+        needleCells = (uint8_t*)Vdp2Planner::Allocate("hud gauges", Vdp2Planner::Usage::Character,
+                                                      NeedleFrames * CellsPerFrame * HudText::CellBytes, HudText::CellBytes,
+                                                      SRL::VDP2::VramBank::A0, 0);
+        if (needleCells == nullptr) return false;
+
+        for (uint8_t frame = 0; frame < NeedleFrames; ++frame) DrawFrame(frame);
+        text.AddCells(needleCells, NeedleFrames * CellsPerFrame);
+
+        text.Text(1, 26, "KM/H");
+        text.Text(6, 25, "G");
+        text.Text(26, 15, "VOLTA     /");
+        text.Text(26, 16, "TEMPO");
+        text.Text(26, 17, "MELHOR");
+        text.Text(26, 18, "POS       /");
+        ready = true;
+        return true;
+    }
+
+    // Angulo do quadro em graus (0 = para cima, horario)
+    static int32_t FrameDegrees(uint8_t frame)
+    {
+        return -SweepDeg / 2 + (SweepDeg * frame) / (NeedleFrames - 1);
+    }
+
+    // Um quadro = aro, marcas e ponteiro desenhados num bloco 32x32 de 4bpp
+    void DrawFrame(uint8_t frame)
+    {
+        uint8_t pixels[GaugePixels][GaugePixels] = {};
+        constexpr int32_t center = GaugePixels / 2;
+
+        auto plot = [&](int32_t x, int32_t y, uint8_t color) {
+            if (x >= 0 && y >= 0 && x < GaugePixels && y < GaugePixels) pixels[y][x] = color;
+        };
+
+        // Ponto a 'radius' pixels do centro no angulo (16.16 do seno/cosseno)
+        auto polar = [&](int32_t degrees, int32_t radius, uint8_t color) {
+            auto angle = SRL::Math::Types::Angle::FromDegrees(SRL::Math::Types::Fxp::Convert(degrees));
+            int32_t s = SRL::Math::Trigonometry::Sin(angle).RawValue();
+            int32_t c = SRL::Math::Trigonometry::Cos(angle).RawValue();
+            plot(center + ((radius * s) >> 16), center - ((radius * c) >> 16), color);
+        };
+
+        for (int32_t y = 0; y < GaugePixels; ++y)
+        {
+            for (int32_t x = 0; x < GaugePixels; ++x)
+            {
+                int32_t dx = x - center;
+                int32_t dy = y - center;
+                int32_t d2 = dx * dx + dy * dy;
+                if (d2 >= 13 * 13 && d2 < 15 * 15) pixels[y][x] = HudText::ColorDial;
+            }
+        }
+
+        // Marcas no inicio, a 1/3, a 2/3 e no fundo de escala
+        for (uint8_t mark = 0; mark < NeedleFrames; mark += 5)
+        {
+            for (int32_t r = 10; r < 13; ++r) polar(FrameDegrees(mark), r, HudText::ColorMark);
+        }
+
+        for (int32_t r = 0; r < 12; ++r) polar(FrameDegrees(frame), r, HudText::ColorNeedle);
+        plot(center, center, HudText::ColorText);
+        plot(center - 1, center, HudText::ColorText);
+        plot(center, center - 1, HudText::ColorText);
+        plot(center - 1, center - 1, HudText::ColorText);
+
+        // Empacota em celulas 8x8 (pixel par no nibble alto), ordem da esquerda para a direita
+        uint8_t* cells = needleCells + frame * CellsPerFrame * HudText::CellBytes;
+        for (uint8_t cell = 0; cell < CellsPerFrame; ++cell)
+        {
+            uint32_t* dst = (uint32_t*)(cells + cell * HudText::CellBytes);
+            uint8_t baseX = (cell % GaugeCells) * 8;
+            uint8_t baseY = (cell / GaugeCells) * 8;
+            for (uint8_t y = 0; y < 8; ++y)
+            {
+                uint32_t line = 0;
+                for (uint8_t x = 0; x < 8; ++x) line |= (uint32_t)pixels[baseY + y][baseX + x] << (28 - x * 4);
+                dst[y] = line;
+            }
+        }
+    }
+
+    // Troca as 16 celulas do mostrador so quando o ponteiro muda de quadro
+    void SetGauge(Gauge& gauge, int32_t value)
+    {
+        if (value < 0) value = 0;
+        if (value > gauge.maxValue) value = gauge.maxValue;
+
+        uint8_t frame = (uint8_t)((value * (NeedleFrames - 1)) / gauge.maxValue);
+        if (frame == gauge.frame) return;
+        gauge.frame = frame;
+
+        const uint8_t* cells = needleCells + frame * CellsPerFrame * HudText::CellBytes;
+        for (uint8_t cell = 0; cell < CellsPerFrame; ++cell)
+        {
+            text.PutName(gauge.column + cell % GaugeCells, gauge.row + cell / GaugeCells, text.CellName(cells + cell * HudText::CellBytes));
+        }
+    }
+
+    /** @brief Atualiza o HUD com o estado do tick; campos iguais nao geram upload
+     */
+    void Tick(const Telemetry& telemetry)
+    {
+        if (!ready) return;
+
+        SetGauge(speedGauge, telemetry.speedKmh);
+        SetGauge(rpmGauge, telemetry.rpm);
+        text.Number(speed, telemetry.speedKmh);
+        text.Number(gear, telemetry.gear);
+        text.Number(lap, telemetry.lap);
+        text.Number(lapCount, telemetry.lapCount);
+        text.Time(lapTime, telemetry.lapTicks);
+        text.Time(bestTime, telemetry.bestLapTicks);
+        text.Number(position, telemetry.position);
+        text.Number(carCount, telemetry.carCount);
+    }
+};
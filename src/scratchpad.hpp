@@ -0,0 +1,85 @@
+#pragma once
+
+#include <srl.hpp>
+
+// Cache do SH-2 escravo em modo duas vias: vias 2 e 3 seguem como cache (2 KB) e as vias 0 e 1
+// viram 2 KB de RAM interna em 0xC0000000, sem espera e sem disputa de barramento com o mestre.
+// Os lacos de culling/fisica do escravo copiam para ca o que leem varias vezes por item.
+namespace Scratchpad
+{
+    constexpr uintptr_t Base = 0xc0000000;
+    constexpr uint32_t Size = 2048;
+    constexpr uintptr_t CacheControl = 0xfffffe92; // CCR, um por CPU
+    constexpr uint32_t CacheThrough = 0x20000000;  // espelho sem cache da memoria
+
+    enum CacheBits : uint8_t
+    {
+        CacheEnable = 1 << 0, // CE
+        TwoWay = 1 << 3,      // TW: vias 0-1 como RAM
+        Purge = 1 << 4,       // CP: invalida todas as linhas
+    };
+
+    constexpr uint32_t LineBytes = 16;
+
+    inline volatile bool slaveReady = false;
+    inline uint32_t used = 0; // bump do job atual (so o escravo usa)
+
+    template<typename T>
+    inline T* Uncached(T* pointer)
+    {
+        return (T*)((uintptr_t)pointer | CacheThrough);
+    }
+
+    // Roda no escravo: o CCR e por CPU, entao tem que ser escrito por ele mesmo
+    inline void EnableOnSlave(void*)
+    {
+        volatile uint8_t* ccr = (volatile uint8_t*)CacheControl;
+        *ccr = 0;
+        *ccr = Purge | TwoWay;
+        *ccr = Purge | TwoWay | CacheEnable;
+        slaveReady = true;
+    }
+
+    // Roda no escravo, no inicio de um job: descarta linhas antigas de dados que o mestre reescreveu
+    // Mantem o modo atual do CCR: serve tambem se o modo duas vias nunca foi ligado
+    inline void PurgeOnSlave()
+    {
+        volatile uint8_t* ccr = (volatile uint8_t*)CacheControl;
+        *ccr = *ccr | Purge;
+    }
+
+    /** @brief Liga a RAM interna do escravo (uma vez, no boot)
+     * @return false se o escravo nao respondeu; os jobs rodam entao sem scratchpad
+     */
+    inline bool Init()
+    {
+        if (*Uncached(&slaveReady)) return true;
+
+        slSlaveFunc(EnableOnSlave, nullptr);
+        for (uint32_t spin = 0; spin < 0x100000 && !*Uncached(&slaveReady); ++spin)
+        {
+        }
+        return *Uncached(&slaveReady);
+    }
+
+    // Inicio de um job: toda a area volta a ficar livre
+    inline void Reset()
+    {
+        used = 0;
+    }
+
+    /** @brief Reserva 'count' elementos alinhados a uma linha de cache
+     * @note So no escravo: a RAM interna e do cache dele, o mestre ve outra coisa em 0xC0000000
+     * @return Ponteiro na RAM interna ou nullptr se nao couber (usar a memoria de origem)
+     */
+    template<typename T>
+    inline T* Take(size_t count)
+    {
+        uint32_t bytes = ((uint32_t)(sizeof(T) * count) + LineBytes - 1) & ~(LineBytes - 1);
+        if (!*Uncached(&slaveReady) || used + bytes > Size) return nullptr;
+
+        T* pointer = (T*)(Base + used);
+        used += bytes;
+        return pointer;
+    }
+} // namespace Scratchpad
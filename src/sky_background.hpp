@@ -3,9 +3,26 @@
 #include <srl.hpp>
 #include "srl_tga.hpp"
 #include "srl_tilemap_interfaces.hpp"
+#include "cd_directory.hpp"
+#include "vdp2_planner.hpp"
 
 struct SkyBackground
 {
+    // Faixa de parallax (linhas da imagem): topo/base interpolados para dar profundidade
+    struct ParallaxBand
+    {
+        uint16_t firstRow;
+        uint16_t lastRow;
+        SRL::Math::Types::Fxp topFactor;    // fator de yaw na primeira linha
+        SRL::Math::Types::Fxp bottomFactor; // fator de yaw na ultima linha
+        SRL::Math::Types::Fxp driftFactor;  // 0 = parado (predios), 1 = nuvens
+    };
+
+    static constexpr size_t MaxBands = 4;
+    static constexpr size_t MaxLines = 240;   // linhas visiveis (NTSC/PAL low-res)
+    static constexpr size_t MaxRows = 512;    // altura maxima do mapa NBG0
+    static constexpr uint8_t NoBand = 0xff;
+
     SRL::Tilemap::Interfaces::Bmp2Tile* tile = nullptr;
     SRL::Math::Types::Vector2D scroll = SRL::Math::Types::Vector2D(SRL::Math::Types::Fxp::Convert(0), SRL::Math::Types::Fxp::Convert(0));
     SRL::Math::Types::Fxp mapWidth = SRL::Math::Types::Fxp::Convert(512);
@@ -16,26 +33,143 @@ struct SkyBackground
     SRL::Math::Types::Fxp driftStep = SRL::Math::Types::Fxp(0.02f);
     bool loaded = false;
 
+    // Line scroll (NBG0): um deslocamento X por linha, enviado via DMA no vblank
+    bool useLineScroll = false;
+    ParallaxBand bands[MaxBands] = {};
+    size_t bandCount = 0;
+    uint8_t rowBand[MaxRows] = {};
+    int32_t lineTable[MaxLines] = {};
+    int32_t* lineTableVram = nullptr;
+    volatile bool lineTableDirty = false;
+    bool lineDoubled = false; // 448i: cada linha da imagem em duas da tela
+    int32_t rowOffset = 0;    // tela dividida: horizonte no centro do viewport (SplitScreen)
+
+    // Tela dividida empilhada: linhas da tabela a partir de secondLine seguem o segundo viewport (NBG1)
+    uint16_t secondLine = MaxLines;
+    SRL::Math::Types::Fxp secondYaw = SRL::Math::Types::Fxp::Convert(0);
+    int32_t secondRow = 0;
+
+    static inline SkyBackground* lineScrollOwner = nullptr;
+
     ~SkyBackground()
     {
+        if (lineScrollOwner == this)
+        {
+            SRL::Core::OnVblank -= UploadLineScroll;
+            lineScrollOwner = nullptr;
+        }
         delete tile;
     }
 
+    /** @brief Define as faixas de parallax (nuvens, morros, skyline...)
+     * @note Linhas fora de qualquer faixa usam yawFactor/drift do plano inteiro
+     */
+    void SetBands(const ParallaxBand* newBands, size_t count)
+    {
+        bandCount = (count < MaxBands) ? count : MaxBands;
+        for (size_t i = 0; i < bandCount; ++i) bands[i] = newBands[i];
+
+        for (size_t row = 0; row < MaxRows; ++row) rowBand[row] = NoBand;
+        for (size_t b = 0; b < bandCount; ++b)
+        {
+            for (size_t row = bands[b].firstRow; row <= bands[b].lastRow && row < MaxRows; ++row)
+            {
+                rowBand[row] = (uint8_t)b;
+            }
+        }
+    }
+
+    // Envia a tabela calculada no frame anterior (chamado no vblank)
+    static void UploadLineScroll()
+    {
+        SkyBackground* sky = lineScrollOwner;
+        if (sky == nullptr || !sky->lineTableDirty || sky->lineTableVram == nullptr) return;
+        slDMACopy(sky->lineTable, sky->lineTableVram, sizeof(sky->lineTable));
+        sky->lineTableDirty = false;
+    }
+
+    // Reserva a tabela em VRAM e liga o line scroll horizontal do NBG0
+    bool EnableLineScroll()
+    {
+        if (lineTableVram == nullptr)
+        {
+            lineTableVram = (int32_t*)Vdp2Planner::Allocate("sky linescroll", Vdp2Planner::Usage::LineScroll, sizeof(lineTable), 4, SRL::VDP2::VramBank::A0, 0);
+        }
+
+        if (lineTableVram == nullptr)
+        {
+            SRL::Debug::Print(1, 13, "Sky line scroll: sem VRAM");
+            useLineScroll = false;
+            return false;
+        }
+
+        slLineScrollTable0(lineTableVram);
+        slLineScrollModeNbg0(LineInterval() | lineHScroll);
+
+        if (lineScrollOwner != this)
+        {
+            if (lineScrollOwner == nullptr) SRL::Core::OnVblank += UploadLineScroll;
+            lineScrollOwner = this;
+        }
+        return true;
+    }
+
+    // Uma entrada da tabela por linha da imagem, tambem no 448i
+    uint16_t LineInterval() const
+    {
+        return lineDoubled ? lineSZ2 : lineSZ1;
+    }
+
+    /** @brief 448i (VideoMode): NBG0 ampliado 2x na vertical e line scroll a cada duas linhas
+     * @note A tabela e o parallax continuam com as mesmas MaxLines entradas
+     */
+    void SetLineDoubling(bool on)
+    {
+        lineDoubled = on;
+        slZoomNbg0(toFIXED(1.0), on ? toFIXED(0.5) : toFIXED(1.0)); // incremento por pixel da tela
+        if (useLineScroll && lineTableVram != nullptr) slLineScrollModeNbg0(LineInterval() | lineHScroll);
+    }
+
+    /** @brief Liga o NBG0 para um ceu ja carregado direto em VRAM (.SKY)
+     * @param width Largura da imagem em pixels
+     * @param height Altura da imagem em pixels
+     */
+    void AttachPacked(uint16_t width, uint16_t height)
+    {
+        delete tile;
+        tile = nullptr;
+
+        mapWidth = SRL::Math::Types::Fxp::Convert(width);
+        mapHeight = SRL::Math::Types::Fxp::Convert(height);
+        SRL::VDP2::NBG0::SetPriority(SRL::VDP2::Priority::Layer6);
+        SRL::VDP2::NBG0::SetScale(SRL::Math::Types::Vector2D(SRL::Math::Types::Fxp(1.0f), SRL::Math::Types::Fxp(1.0f)));
+        SRL::VDP2::NBG0::ScrollEnable();
+        if (lineDoubled) SetLineDoubling(true);
+
+        if (useLineScroll) EnableLineScroll();
+        loaded = true;
+    }
+
+    // Quebra no tamanho do mapa; mascara quando o tamanho e potencia de 2 (512x256)
+    static int32_t WrapRaw(int32_t raw, int32_t sizeRaw)
+    {
+        if ((sizeRaw & (sizeRaw - 1)) == 0) return raw & (sizeRaw - 1);
+        raw %= sizeRaw;
+        return raw < 0 ? raw + sizeRaw : raw;
+    }
+
     bool Load(const char* const* paths, size_t count)
     {
         delete tile;
         tile = nullptr;
         loaded = false;
 
-        for (size_t i = 0; i < count; ++i)
+        const char* skyPath = CdDirectory::ResolvePath(paths, count);
+        if (skyPath != nullptr)
         {
-            SRL::Cd::File skyFile(paths[i]);
-            if (!skyFile.Exists())
-            {
-                continue;
-            }
+            SRL::Cd::File skyFile(skyPath);
 
-            SRL::Debug::Print(1, 10, "Sky load: %s", paths[i]);
+            SRL::Debug::Print(1, 10, "Sky load: %s", skyPath);
             SRL::Bitmap::TGA skyBmp(&skyFile);
             auto skyInfo = skyBmp.GetInfo();
             SRL::Debug::Print(1, 11, "Sky info: %u x %u mode %d pal %p",
@@ -51,11 +185,17 @@ struct SkyBackground
             mapWidth = SRL::Math::Types::Fxp::Convert(tileInfo.MapWidth * (tileInfo.CharSize ? 16 : 8));
             mapHeight = SRL::Math::Types::Fxp::Convert(tileInfo.MapHeight * (tileInfo.CharSize ? 16 : 8));
 
+            auto vramBefore = Vdp2Planner::TakeSnapshot();
             SRL::VDP2::NBG0::LoadTilemap(*tile);
+            Vdp2Planner::RecordSince(vramBefore, "sky NBG0", Vdp2Planner::Layer::Normal,
+                                     Vdp2Planner::CyclesFor(Vdp2Planner::Usage::Character, skyInfo.ColorMode), Vdp2Planner::CyclesFor(Vdp2Planner::Usage::PatternName));
             SRL::VDP2::NBG0::SetPriority(SRL::VDP2::Priority::Layer6); // acima do backcolor
             SRL::Math::Types::Vector2D skyScale = SRL::Math::Types::Vector2D(SRL::Math::Types::Fxp(1.0f), SRL::Math::Types::Fxp(1.0f));
             SRL::VDP2::NBG0::SetScale(skyScale);
             SRL::VDP2::NBG0::ScrollEnable();
+            if (lineDoubled) SetLineDoubling(true);
+
+            if (useLineScroll) EnableLineScroll();
 
             loaded = true;
             return true;
@@ -78,17 +218,85 @@ struct SkyBackground
             drift -= mapWidth;
         }
 
-        SRL::Math::Types::Fxp yawOffset = yawFactor * SRL::Math::Types::Fxp::Convert(yawDeg);
-        SRL::Math::Types::Fxp scrollX = drift + yawOffset;
-        while (scrollX.RawValue() >= mapWidth.RawValue()) scrollX -= mapWidth;
-        while (scrollX.RawValue() < 0) scrollX += mapWidth;
-
-        scroll.X = scrollX;
+        SRL::Math::Types::Fxp yaw = SRL::Math::Types::Fxp::Convert(yawDeg);
         SRL::Math::Types::Fxp pitchOffset = pitchFactor * SRL::Math::Types::Fxp::Convert(pitchDeg);
-        SRL::Math::Types::Fxp scrollY = pitchOffset;
-        while (scrollY.RawValue() >= mapHeight.RawValue()) scrollY -= mapHeight;
-        while (scrollY.RawValue() < 0) scrollY += mapHeight;
-        scroll.Y = scrollY;
+        scroll.Y = SRL::Math::Types::Fxp::BuildRaw(WrapRaw(pitchOffset.RawValue() + (rowOffset << 16), mapHeight.RawValue()));
+
+        if (useLineScroll && lineTableVram != nullptr)
+        {
+            // X fica na tabela por linha; o plano so rola em Y
+            UpdateLineTable(yaw, scroll.Y.As<int32_t>());
+            scroll.X = SRL::Math::Types::Fxp::Convert(0);
+            SRL::VDP2::NBG0::SetPosition(scroll);
+            return;
+        }
+
+        SRL::Math::Types::Fxp scrollX = drift + yawFactor * yaw;
+        scroll.X = SRL::Math::Types::Fxp::BuildRaw(WrapRaw(scrollX.RawValue(), mapWidth.RawValue()));
         SRL::VDP2::NBG0::SetPosition(scroll);
     }
+
+    /** @brief Scroll do segundo viewport (NBG1 com a mesma regiao do ceu); chamar antes do Update
+     * @param firstLine Primeira linha da tabela no viewport (empilhado: NBG1 le a mesma tabela) ou
+     *                  MaxLines (lado a lado: as linhas sao dos dois viewports, NBG1 rola sem line scroll)
+     */
+    SRL::Math::Types::Vector2D SecondView(uint16_t firstLine, int32_t yawDeg, int32_t pitchDeg, int32_t secondRowOffset)
+    {
+        SRL::Math::Types::Fxp yaw = SRL::Math::Types::Fxp::Convert(yawDeg);
+        SRL::Math::Types::Fxp pitchOffset = pitchFactor * SRL::Math::Types::Fxp::Convert(pitchDeg);
+        SRL::Math::Types::Fxp row = SRL::Math::Types::Fxp::BuildRaw(WrapRaw(pitchOffset.RawValue() + (secondRowOffset << 16), mapHeight.RawValue()));
+
+        secondLine = (useLineScroll && lineTableVram != nullptr) ? firstLine : MaxLines;
+        secondYaw = yaw;
+        secondRow = row.As<int32_t>();
+        if (secondLine < MaxLines) return SRL::Math::Types::Vector2D(SRL::Math::Types::Fxp::Convert(0), row);
+
+        SRL::Math::Types::Fxp scrollX = drift + yawFactor * yaw;
+        return SRL::Math::Types::Vector2D(SRL::Math::Types::Fxp::BuildRaw(WrapRaw(scrollX.RawValue(), mapWidth.RawValue())), row);
+    }
+
+    // Fim da tela dividida: a tabela volta a ser toda do NBG0
+    void EndSecondView()
+    {
+        secondLine = MaxLines;
+    }
+
+    // Calcula o deslocamento X de cada linha visivel a partir das faixas
+    void UpdateLineTable(const SRL::Math::Types::Fxp& yaw, int32_t scrollRow)
+    {
+        // Nao reescreve enquanto o vblank ainda nao enviou a tabela anterior
+        if (lineTableDirty) return;
+
+        FillLines(yaw, scrollRow, 0, secondLine);
+        if (secondLine < MaxLines) FillLines(secondYaw, secondRow, secondLine, MaxLines);
+        lineTableDirty = true;
+    }
+
+    // Linhas [first, last) da tabela para um yaw e uma linha de scroll
+    void FillLines(const SRL::Math::Types::Fxp& yaw, int32_t scrollRow, size_t first, size_t last)
+    {
+        int32_t baseRaw[MaxBands];
+        int32_t stepRaw[MaxBands];
+        for (size_t b = 0; b < bandCount; ++b)
+        {
+            const ParallaxBand& band = bands[b];
+            int32_t top = (band.topFactor * yaw + band.driftFactor * drift).RawValue();
+            int32_t bottom = (band.bottomFactor * yaw + band.driftFactor * drift).RawValue();
+            int32_t span = (int32_t)band.lastRow - (int32_t)band.firstRow;
+            baseRaw[b] = top;
+            stepRaw[b] = span > 0 ? (bottom - top) / span : 0;
+        }
+
+        const int32_t widthRaw = mapWidth.RawValue();
+        const int32_t rows = mapHeight.As<int32_t>();
+        const int32_t planeRaw = (drift + yawFactor * yaw).RawValue();
+        for (size_t line = first; line < last; ++line)
+        {
+            int32_t row = (int32_t)line + scrollRow;
+            row = (rows & (rows - 1)) == 0 ? (row & (rows - 1)) : (row % rows);
+            uint8_t b = (row < (int32_t)MaxRows) ? rowBand[row] : NoBand;
+            int32_t value = (b == NoBand) ? planeRaw : baseRaw[b] + stepRaw[b] * (row - (int32_t)bands[b].firstRow);
+            lineTable[line] = WrapRaw(value, widthRaw);
+        }
+    }
 };
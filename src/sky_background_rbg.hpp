@@ -3,6 +3,8 @@
 #include <srl.hpp>
 #include "srl_tga.hpp"
 #include "srl_tilemap_interfaces.hpp"
+#include "cd_directory.hpp"
+#include "vdp2_planner.hpp"
 
 struct SkyBackgroundRbg
 {
@@ -46,15 +48,12 @@ struct SkyBackgroundRbg
         // RBG0 deve ser configurado antes das demais camadas
         SRL::VDP2::RBG0::SetRotationMode(SRL::VDP2::RotationMode::OneAxis); // sem VRAM extra
 
-        for (size_t i = 0; i < count; ++i)
+        const char* skyPath = CdDirectory::ResolvePath(paths, count);
+        if (skyPath != nullptr)
         {
-            SRL::Cd::File skyFile(paths[i]);
-            if (!skyFile.Exists())
-            {
-                continue;
-            }
+            SRL::Cd::File skyFile(skyPath);
 
-            SRL::Debug::Print(1, 10, "RBG sky load: %s", paths[i]);
+            SRL::Debug::Print(1, 10, "RBG sky load: %s", skyPath);
             SRL::Bitmap::TGA skyBmp(&skyFile);
             auto skyInfo = skyBmp.GetInfo();
             SRL::Debug::Print(1, 11, "RBG sky info: %u x %u mode %d pal %p",
@@ -67,7 +66,10 @@ struct SkyBackgroundRbg
                               tileInfo.MapWidth, tileInfo.MapHeight,
                               tileInfo.CharSize, tileInfo.MapMode, tileInfo.CellByteSize);
 
+            auto vramBefore = Vdp2Planner::TakeSnapshot();
             SRL::VDP2::RBG0::LoadTilemap(*tile);
+            Vdp2Planner::RecordSince(vramBefore, "sky RBG0", Vdp2Planner::Layer::Rotation,
+                                     Vdp2Planner::CyclesFor(Vdp2Planner::Usage::Character, skyInfo.ColorMode), Vdp2Planner::CyclesFor(Vdp2Planner::Usage::PatternName));
             SRL::VDP2::RBG0::SetPriority(SRL::VDP2::Priority::Layer6); // abaixo de sprites, acima do backcolor
             SRL::VDP2::RBG0::ScrollEnable();
             loaded = true;
@@ -2,6 +2,8 @@
 
 #include <srl.hpp>
 #include "srl_tga.hpp"
+#include "cd_directory.hpp"
+#include "vdp2_planner.hpp"
 
 // Bitmap em RBG0 (512x256 8bpp) para eliminar tiling
 struct SkyBackgroundRbgBitmap
@@ -21,11 +23,13 @@ struct SkyBackgroundRbgBitmap
         bmp = nullptr;
         loaded = false;
 
-        // Seleciona arquivo
+        // Seleciona arquivo (indice do CD, sem sondar candidatos)
         for (size_t i = 0; i < count; ++i)
         {
-            SRL::Cd::File skyFile(paths[i]);
-            if (!skyFile.Exists()) continue;
+            const char* skyPath = CdDirectory::ResolvePath(&paths[i], 1);
+            if (skyPath == nullptr) continue;
+
+            SRL::Cd::File skyFile(skyPath);
 
             bmp = new SRL::Bitmap::TGA(&skyFile);
             auto info = bmp->GetInfo();
@@ -46,8 +50,15 @@ struct SkyBackgroundRbgBitmap
             palette = SRL::CRAM::Palette(SRL::CRAM::TextureColorMode::Paletted256, palId);
             palette.Load((SRL::Types::HighColor*)info.Palette, 256);
 
-            // endere?o de VRAM (usar A0 base)
-            uint8_t* vram = (uint8_t*)VDP2_VRAM_A0;
+            // endere?o de VRAM: banco A0 inteiro reservado pelo planner
+            uint8_t* vram = (uint8_t*)Vdp2Planner::Allocate("sky bitmap", Vdp2Planner::Usage::Bitmap, info.Width * info.Height, 0x20000,
+                                                             SRL::VDP2::VramBank::A0, Vdp2Planner::CyclesFor(Vdp2Planner::Usage::Bitmap, info.ColorMode),
+                                                             Vdp2Planner::Layer::Rotation);
+            if (vram == nullptr)
+            {
+                SRL::CRAM::SetBankUsedState(palId, SRL::CRAM::TextureColorMode::Paletted256, false);
+                delete bmp; bmp = nullptr; return false;
+            }
             // copia bitmap (512*256 bytes)
             slDMACopy((void*)bmp->GetData(), vram, info.Width * info.Height);
 
@@ -3,15 +3,18 @@
 #include <srl.hpp>
 #include "sky_background.hpp"
 #include "sky_background_dome.hpp"
+#include "ground_plane.hpp"
 
 // Gerencia m?ltiplas camadas VDP2 para liberar VDP1: horizonte (NBG0) + domo (RBG0)
 struct SkyEnvironment
 {
     bool useDome = false; // dome off
     bool useHorizon = true; // NBG0 on
+    bool useGround = false; // RBG0 chao (exclusivo com o domo)
 
     SkyBackground horizon;     // NBG0
     SkyBackgroundDome dome;    // RBG0 (desligado)
+    GroundPlane ground;        // RBG0 (chao distante)
 
     // Configura fatores padr?es
     void Configure()
@@ -19,11 +22,27 @@ struct SkyEnvironment
         // NBG0 scroll control
         horizon.yawFactor = SRL::Math::Types::Fxp(0.5f);
         horizon.driftStep = SRL::Math::Types::Fxp(0.0015f); // +50% de velocidade, ainda suave
+
+        // Parallax por linha (skybox 512x256): nuvens lentas, morros, skyline acompanhando o yaw
+        const SkyBackground::ParallaxBand bands[] = {
+            {0, 95, SRL::Math::Types::Fxp(0.20f), SRL::Math::Types::Fxp(0.35f), SRL::Math::Types::Fxp(1.0f)},   // nuvens
+            {96, 175, SRL::Math::Types::Fxp(0.35f), SRL::Math::Types::Fxp(0.50f), SRL::Math::Types::Fxp(0.0f)}, // morros
+            {176, 255, SRL::Math::Types::Fxp(0.50f), SRL::Math::Types::Fxp(0.50f), SRL::Math::Types::Fxp(0.0f)} // skyline
+        };
+        horizon.SetBands(bands, sizeof(bands) / sizeof(bands[0]));
+        horizon.useLineScroll = true;
     }
 
-    void Load(const char* const* paths, size_t count)
+    // RBG0 primeiro: precisa ser configurado antes das demais camadas
+    void LoadGround(const char* const* paths, size_t count)
     {
-        if (useHorizon)
+        if (useGround && !useDome)
+            ground.Load(paths, count);
+    }
+
+    void Load(const char* const* paths, size_t count, bool horizonLoaded = false)
+    {
+        if (useHorizon && !horizonLoaded)
             horizon.Load(paths, count);
         if (useDome)
             dome.Load(paths, count);
@@ -36,4 +55,10 @@ struct SkyEnvironment
         if (useDome)
             dome.Update(yawDeg, viewYawDeg, viewPitchDeg);
     }
+
+    void UpdateGround(const Camera::State& camera)
+    {
+        if (useGround && !useDome)
+            ground.Update(camera);
+    }
 };
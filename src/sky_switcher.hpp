@@ -0,0 +1,610 @@
+#pragma once
+
+#include <srl.hpp>
+#include "cd_directory.hpp"
+#include "vdp2_planner.hpp"
+#include "sky_tiles.hpp"
+#include "sky_background.hpp"
+#include "work_ram.hpp"
+#include "scratchpad.hpp"
+
+// Troca de ceu em tempo de execucao sem travar o frame:
+// leitura assincrona do CD (GFS sem espera, um passo por frame) -> (so TGA) conversao no SH-2 escravo -> upload por vblank
+// na regiao VDP2 ociosa -> crossfade NBG1 sobre NBG0 (color calc) -> troca atomica do NBG0.
+// Arquivos .SKY (tools/sky2vdp2) ja vem no layout do VDP2 e pulam a conversao.
+// Com o chao RBG0 so A0 e B1 sobram para NBG, e as duas regioes nao tem o mesmo tamanho: um ceu que nao
+// cabe na ociosa troca pela da frente, com o NBG0 apagado (fade para o fundo) durante o upload.
+struct SkySwitcher
+{
+    // Cabecalho do .SKY (big-endian, igual ao SH-2)
+    struct PackedHeader
+    {
+        char magic[4];
+        uint16_t width;
+        uint16_t height;
+        uint16_t cellCount;
+        uint16_t reserved;
+        uint16_t palette[256];
+        uint16_t map[SkyTiles::MapSize * SkyTiles::MapSize];
+        // seguido por cellCount * 64 bytes de celulas
+    };
+
+    enum class Stage : uint8_t
+    {
+        Idle,
+        Reading,
+        Converting,
+        Uploading,
+        Fading,
+        FadingOut, // troca pela regiao da frente: NBG0 some antes do upload
+        FadingIn,
+        Split, // NBG1 emprestado ao segundo viewport (SplitScreen); sem trocas ate EndSplit
+    };
+
+    static constexpr uint32_t SectorBytes = 2048;
+    static constexpr int32_t ReadChunkSectors = 8;        // maximo copiado do buffer do CD por frame
+    static constexpr uint32_t UploadChunkBytes = 4096;    // por vblank
+    static constexpr uint8_t FadeStart = 31;              // 31 = camada quase invisivel
+    static constexpr uint8_t FadeStep = 2;                // fade para o fundo: 16 frames em cada sentido
+    static constexpr uint32_t MapRegionBytes = SkyTiles::MapSize * SkyTiles::MapSize * sizeof(uint16_t);
+    static constexpr uint32_t BankBytes = 0x20000;
+
+    // B1: banco inteiro menos o mapa. A0: 80 KB com o mapa; os 48 KB restantes sao da tabela de
+    // line scroll e do HUD (fonte, mapa alinhado, medidores e copias do 448i, ~40 KB)
+    static constexpr uint16_t RegionCells[2] = {1920, 1152};
+
+    // Regiao VDP2 de um ceu: mapa 64x64 + celulas no mesmo banco + banco de paleta
+    struct Region
+    {
+        uint8_t* cells = nullptr;
+        uint16_t* map = nullptr;
+        uint16_t capacity = 0; // celulas
+        int32_t paletteId = -1;
+    };
+
+    Region regions[2];
+    uint8_t front = 0;  // regiao no NBG0
+    uint8_t target = 0; // regiao que recebe o upload
+    bool fadeThrough = false;
+    SkyTiles tiles;
+    Stage stage = Stage::Idle;
+
+    // Origem do upload: tiles (TGA convertido) ou staging (.SKY)
+    const uint8_t* srcCells = nullptr;
+    uint16_t* srcMap = nullptr;
+    const uint16_t* srcPalette = nullptr;
+    uint16_t srcCellCount = 0;
+    uint16_t srcWidth = 0;
+    uint16_t srcHeight = 0;
+    bool packed = false;
+    char packedPath[32] = {};
+    const char* openedPath = nullptr; // ultimo aberto: packedPath ou um candidato (valido so durante a chamada)
+
+    GfsHn file = nullptr;
+    uint8_t* staging = nullptr;
+    uint32_t stagingBytes = 0; // setores inteiros: o GFS copia setor a setor
+    uint32_t fileSize = 0;
+    uint32_t readOffset = 0;   // bytes que ja chegaram na staging
+    uint32_t uploadOffset = 0;
+    uint8_t fadeRate = FadeStart;
+    volatile bool convertDone = false;
+    volatile bool convertOk = false;
+    bool ready = false;
+
+    static inline SkySwitcher* uploadOwner = nullptr;
+
+    ~SkySwitcher()
+    {
+        if (uploadOwner == this)
+        {
+            SRL::Core::OnVblank -= UploadChunk;
+            uploadOwner = nullptr;
+        }
+        CloseFile();
+        WorkRam::Free(staging);
+    }
+
+    void CloseFile()
+    {
+        if (file != nullptr) GFS_Close(file);
+        file = nullptr;
+    }
+
+    uint32_t Sectors() const
+    {
+        return (fileSize + SectorBytes - 1) / SectorBytes;
+    }
+
+    bool IsBusy() const
+    {
+        return stage != Stage::Idle;
+    }
+
+    // Escravo ocupado com a conversao da TGA: outros jobs esperam
+    bool SlaveBusy() const
+    {
+        return stage == Stage::Converting;
+    }
+
+    /** @brief Reserva as duas regioes (B1 e A0, mapa e celulas no mesmo banco) e as paletas
+     * @note Depois do chao (A1/B0) e antes da tabela de line scroll e do HUD (resto do A0)
+     */
+    bool Init()
+    {
+        if (ready) return true;
+
+        const SRL::VDP2::VramBank banks[2] = {SRL::VDP2::VramBank::B1, SRL::VDP2::VramBank::A0};
+        for (size_t i = 0; i < 2; ++i)
+        {
+            // Celulas em qualquer ponto do banco: o nome de 1 word leva os 12 bits baixos do numero
+            // absoluto e o banco vem dos bits suplementares (BuildPatternNames); so nao pode cruzar o banco
+            regions[i].map = (uint16_t*)Vdp2Planner::Allocate("sky swap map", Vdp2Planner::Usage::PatternName, MapRegionBytes, 0x2000, banks[i],
+                                                               Vdp2Planner::CyclesFor(Vdp2Planner::Usage::PatternName));
+            regions[i].cells = (uint8_t*)Vdp2Planner::Allocate("sky swap cel", Vdp2Planner::Usage::Character, RegionCells[i] * SkyTiles::CellBytes,
+                                                                SkyTiles::CellBytes, banks[i], Vdp2Planner::CyclesFor(Vdp2Planner::Usage::Character));
+            regions[i].capacity = RegionCells[i];
+            regions[i].paletteId = SRL::CRAM::GetFreeBank(SRL::CRAM::TextureColorMode::Paletted256);
+            if (regions[i].cells == nullptr || regions[i].map == nullptr || regions[i].paletteId < 0)
+            {
+                SRL::Debug::Print(1, 13, "Sky swap: sem VRAM/CRAM");
+                return false;
+            }
+            SRL::CRAM::SetBankUsedState(regions[i].paletteId, SRL::CRAM::TextureColorMode::Paletted256, true);
+        }
+
+        uploadOwner = this;
+        SRL::Core::OnVblank += UploadChunk;
+        ready = true;
+        return true;
+    }
+
+    // "skybox_1.tga" -> "skybox_1.SKY"
+    static bool PackedPath(const char* path, char* out, size_t outLength)
+    {
+        size_t dot = 0;
+        size_t length = 0;
+        for (; path[length] != '\0'; ++length)
+        {
+            if (path[length] == '.') dot = length;
+        }
+
+        if (dot == 0 || dot + 5 > outLength) return false;
+        for (size_t i = 0; i < dot; ++i) out[i] = path[i];
+        out[dot + 0] = '.';
+        out[dot + 1] = 'S';
+        out[dot + 2] = 'K';
+        out[dot + 3] = 'Y';
+        out[dot + 4] = '\0';
+        return true;
+    }
+
+    // Primeiro candidato com .SKY no disco; senao o primeiro TGA existente
+    const char* ResolveSky(const char* const* paths, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (PackedPath(paths[i], packedPath, sizeof(packedPath)) && CdDirectory::Find(packedPath) != nullptr)
+            {
+                packed = true;
+                return packedPath;
+            }
+        }
+
+        packed = false;
+        return CdDirectory::ResolvePath(paths, count);
+    }
+
+    // Aponta a origem do upload para o .SKY lido em staging
+    bool UsePacked()
+    {
+        const PackedHeader* header = (const PackedHeader*)staging;
+        if (fileSize < sizeof(PackedHeader) || header->magic[0] != 'S' || header->magic[1] != 'K' || header->magic[2] != 'Y' ||
+            header->cellCount > SkyTiles::MaxCells || fileSize < sizeof(PackedHeader) + header->cellCount * SkyTiles::CellBytes)
+        {
+            return false;
+        }
+
+        srcCells = staging + sizeof(PackedHeader);
+        srcMap = (uint16_t*)header->map;
+        srcPalette = header->palette;
+        srcCellCount = header->cellCount;
+        srcWidth = header->width;
+        srcHeight = header->height;
+        return true;
+    }
+
+    void UseConverted()
+    {
+        srcCells = tiles.cells;
+        srcMap = tiles.map;
+        srcPalette = tiles.palette;
+        srcCellCount = tiles.cellCount;
+        srcWidth = tiles.width;
+        srcHeight = tiles.height;
+    }
+
+    bool OpenSky(const char* const* paths, size_t count)
+    {
+        openedPath = ResolveSky(paths, count);
+        if (openedPath == nullptr) return false;
+
+        CloseFile();
+        int32_t fid = GFS_NameToId((Sint8*)openedPath);
+        file = fid >= 0 ? GFS_Open(fid) : nullptr;
+        if (file == nullptr) return false;
+
+        int32_t sectorSize = 0, sectorCount = 0, lastSize = 0;
+        GFS_GetFileSize(fid, &sectorSize, &sectorCount, &lastSize);
+        fileSize = sectorCount > 0 ? (uint32_t)((sectorCount - 1) * sectorSize + lastSize) : 0;
+        if (fileSize == 0)
+        {
+            CloseFile();
+            return false;
+        }
+
+        uint32_t bytes = Sectors() * SectorBytes;
+        if (staging == nullptr || stagingBytes < bytes)
+        {
+            // Arquivo inteiro so passa por aqui a caminho da VRAM: LWRAM
+            WorkRam::Free(staging);
+            staging = (uint8_t*)WorkRam::Allocate("sky staging", WorkRam::Region::Low, bytes);
+            stagingBytes = staging != nullptr ? bytes : 0;
+            if (staging == nullptr)
+            {
+                CloseFile();
+                return false;
+            }
+        }
+
+        // Staging na LWRAM, fora do alcance do DMA da SCU: o GFS copia pela CPU
+        GFS_SetTmode(file, GFS_TMODE_CPU);
+        readOffset = 0;
+        if (!packed) tiles.Allocate();
+        return true;
+    }
+
+    /** @brief Carrega um .SKY de uma vez (boot): uma leitura + um DMA, NBG0 ja aponta para ele
+     * @return false se nao ha .SKY para os candidatos (use o caminho TGA)
+     */
+    bool LoadNow(const char* const* paths, size_t count, SkyBackground& sky)
+    {
+        if (!ready || IsBusy() || !OpenSky(paths, count)) return false;
+
+        bool read = packed && GFS_Fread(file, (int32_t)Sectors(), staging, (int32_t)stagingBytes) >= (int32_t)fileSize;
+        CloseFile();
+        if (!read || !UsePacked()) return false;
+
+        // Nada na tela ainda: a menor regiao que couber, para a maior ficar livre para o proximo
+        uint8_t smaller = regions[1].capacity < regions[0].capacity ? 1 : 0;
+        target = srcCellCount <= regions[smaller].capacity ? smaller : (uint8_t)(smaller ^ 1);
+        if (srcCellCount > regions[target].capacity) return false;
+
+        const Region& region = regions[target];
+        BuildPatternNames();
+        slDMACopy((void*)srcCells, region.cells, srcCellCount * SkyTiles::CellBytes);
+        slDMACopy(srcMap, region.map, MapRegionBytes);
+        LoadPalette();
+
+        SRL::Debug::Print(1, 10, "Sky load: %s (%u cel)", openedPath, srcCellCount);
+        Commit(sky);
+        sky.AttachPacked(srcWidth, srcHeight);
+        return true;
+    }
+
+    /** @brief Pede a troca para outro ceu (ignorado enquanto uma troca esta em andamento)
+     */
+    bool Request(const char* const* paths, size_t count)
+    {
+        if (!ready || IsBusy() || !OpenSky(paths, count)) return false;
+
+        // O drive le sozinho para o buffer do CD; cada Update so copia o que ja chegou
+        GFS_SetTransPara(file, ReadChunkSectors);
+        GFS_NwCdRead(file, (int32_t)Sectors());
+        GFS_NwFread(file, (int32_t)Sectors(), staging, (int32_t)stagingBytes);
+        stage = Stage::Reading;
+        return true;
+    }
+
+    // Roda no SH-2 escravo: so toca memoria ja alocada
+    static void ConvertOnSlave(void* arg)
+    {
+        // O mestre acabou de escrever staging/fileSize e o buffer: nada de linhas velhas no cache do escravo
+        Scratchpad::PurgeOnSlave();
+        SkySwitcher* self = (SkySwitcher*)arg;
+        self->convertOk = self->tiles.ConvertTga(self->staging, self->fileSize);
+        self->convertDone = true;
+    }
+
+    // Le o flag pelo endereco sem cache: o escravo escreve direto na memoria
+    bool SlaveFinished() const
+    {
+        return *(volatile bool*)((uint32_t)&convertDone | 0x20000000);
+    }
+
+    /** @brief Escolhe a regiao do ceu lido: a ociosa (crossfade) ou, se ele so couber nela, a da frente
+     * @return false se o ceu nao cabe em nenhuma
+     */
+    bool ChooseTarget()
+    {
+        uint8_t back = front ^ 1;
+        fadeThrough = srcCellCount > regions[back].capacity;
+        target = fadeThrough ? front : back;
+        if (srcCellCount <= regions[target].capacity) return true;
+
+        SRL::Debug::Print(1, 13, "Sky swap: %u cel nao cabem", srcCellCount);
+        return false;
+    }
+
+    // Nomes de padrao e primeiro passo da troca (upload direto ou fade do ceu atual)
+    void StartUpload()
+    {
+        BuildPatternNames();
+        uploadOffset = 0;
+        if (!fadeThrough)
+        {
+            stage = Stage::Uploading;
+            return;
+        }
+
+        fadeRate = 0;
+        slColorCalc(CC_RATE | CC_TOP);
+        slColorCalcOn(NBG0ON);
+        slColRateNbg0(fadeRate);
+        stage = Stage::FadingOut;
+    }
+
+    void LoadPalette()
+    {
+        SRL::CRAM::Palette palette(SRL::CRAM::TextureColorMode::Paletted256, regions[target].paletteId);
+        palette.Load((SRL::Types::HighColor*)srcPalette, 256);
+    }
+
+    // Envia um bloco de celulas/mapa para a regiao de destino (chamado no vblank)
+    static void UploadChunk()
+    {
+        SkySwitcher* self = uploadOwner;
+        if (self == nullptr || self->stage != Stage::Uploading) return;
+
+        const Region& region = self->regions[self->target];
+        const uint32_t cellBytes = self->srcCellCount * SkyTiles::CellBytes;
+        const uint32_t total = cellBytes + MapRegionBytes;
+
+        uint32_t offset = self->uploadOffset;
+        uint32_t chunk = (total - offset < UploadChunkBytes) ? (total - offset) : UploadChunkBytes;
+        if (offset < cellBytes)
+        {
+            if (chunk > cellBytes - offset) chunk = cellBytes - offset;
+            slDMACopy((void*)(self->srcCells + offset), region.cells + offset, chunk);
+        }
+        else
+        {
+            uint32_t mapOffset = offset - cellBytes;
+            slDMACopy((uint8_t*)self->srcMap + mapOffset, (uint8_t*)region.map + mapOffset, chunk);
+        }
+
+        self->uploadOffset = offset + chunk;
+    }
+
+    // Numeros de celula relativos a regiao -> 12 bits baixos do numero absoluto (como no HudText),
+    // mais o banco de paleta (1 word, 256 cores)
+    void BuildPatternNames()
+    {
+        const Region& region = regions[target];
+        const uint16_t cellBase = (uint16_t)(((uint32_t)region.cells & (BankBytes - 1)) >> 5);
+        const uint16_t paletteBits = (uint16_t)((region.paletteId & 7) << 12);
+        for (uint32_t i = 0; i < (uint32_t)SkyTiles::MapSize * SkyTiles::MapSize; ++i)
+        {
+            srcMap[i] = (uint16_t)(((srcMap[i] + cellBase) & 0x0fff) | paletteBits);
+        }
+    }
+
+    // Mostra a regiao ociosa no NBG1, acima do NBG0, com o mesmo scroll
+    void BeginFade(SkyBackground& sky)
+    {
+        const Region& region = regions[target];
+        LoadPalette();
+
+        slCharNbg1(COL_TYPE_256, CHAR_SIZE_1x1);
+        slPageNbg1(region.cells, 0, PNB_1WORD | CN_12BIT);
+        slPlaneNbg1(PL_SIZE_1x1);
+        slMapNbg1(region.map, region.map, region.map, region.map);
+        if (sky.useLineScroll && sky.lineTableVram != nullptr)
+        {
+            slLineScrollTable1(sky.lineTableVram);
+            slLineScrollModeNbg1(sky.LineInterval() | lineHScroll);
+        }
+        slZoomNbg1(toFIXED(1.0), sky.lineDoubled ? toFIXED(0.5) : toFIXED(1.0));
+
+        SRL::VDP2::NBG0::SetPriority(SRL::VDP2::Priority::Layer5);
+        SRL::VDP2::NBG1::SetPriority(SRL::VDP2::Priority::Layer6);
+        fadeRate = FadeStart;
+        slColorCalc(CC_RATE | CC_TOP);
+        slColorCalcOn(NBG1ON);
+        slColRateNbg1(fadeRate);
+        SRL::VDP2::NBG1::ScrollEnable();
+        stage = Stage::Fading;
+    }
+
+    /** @brief Tela dividida: NBG1 mostra o mesmo ceu do NBG0 (regiao da frente, sem VRAM nova)
+     * @param lineScroll NBG1 le a tabela de line scroll do NBG0 (viewports empilhados)
+     * @return false durante uma troca de ceu
+     */
+    bool BeginSplit(const SkyBackground& sky, bool lineScroll)
+    {
+        if (!ready || stage != Stage::Idle) return false;
+
+        const Region& region = regions[front];
+        slCharNbg1(COL_TYPE_256, CHAR_SIZE_1x1);
+        slPageNbg1(region.cells, 0, PNB_1WORD | CN_12BIT);
+        slPlaneNbg1(PL_SIZE_1x1);
+        slMapNbg1(region.map, region.map, region.map, region.map);
+        if (sky.useLineScroll && sky.lineTableVram != nullptr) slLineScrollTable1(sky.lineTableVram);
+        stage = Stage::Split;
+        ApplySplit(sky, lineScroll);
+
+        SRL::VDP2::NBG1::SetPriority(SRL::VDP2::Priority::Layer6);
+        SRL::VDP2::NBG1::ScrollEnable();
+        return true;
+    }
+
+    /** @brief Line scroll e zoom vertical do NBG1 iguais aos do NBG0 (troca de arranjo ou de 224/448i)
+     */
+    void ApplySplit(const SkyBackground& sky, bool lineScroll)
+    {
+        if (stage != Stage::Split) return;
+
+        bool table = lineScroll && sky.useLineScroll && sky.lineTableVram != nullptr;
+        slLineScrollModeNbg1(table ? (sky.LineInterval() | lineHScroll) : 0);
+        slZoomNbg1(toFIXED(1.0), sky.lineDoubled ? toFIXED(0.5) : toFIXED(1.0));
+    }
+
+    void UpdateSplit(const SRL::Math::Types::Vector2D& scroll)
+    {
+        if (stage == Stage::Split) SRL::VDP2::NBG1::SetPosition(scroll);
+    }
+
+    void EndSplit()
+    {
+        if (stage != Stage::Split) return;
+        SRL::VDP2::NBG1::ScrollDisable();
+        stage = Stage::Idle;
+    }
+
+    // Fim do crossfade: NBG0 passa a ler a nova regiao, NBG1 e desligado
+    void Commit(SkyBackground& sky)
+    {
+        const Region& region = regions[target];
+        slCharNbg0(COL_TYPE_256, CHAR_SIZE_1x1);
+        slPageNbg0(region.cells, 0, PNB_1WORD | CN_12BIT);
+        slPlaneNbg0(PL_SIZE_1x1);
+        slMapNbg0(region.map, region.map, region.map, region.map);
+        SRL::VDP2::NBG0::SetPriority(SRL::VDP2::Priority::Layer6);
+
+        slColorCalcOn(0);
+        SRL::VDP2::NBG1::ScrollDisable();
+
+        sky.mapWidth = SRL::Math::Types::Fxp::Convert(srcWidth);
+        sky.mapHeight = SRL::Math::Types::Fxp::Convert(srcHeight);
+        front = target;
+        stage = Stage::Idle;
+    }
+
+    /** @brief Avanca a troca um passo por frame
+     * @param sky Camada NBG0 atual (fornece scroll e tabela de line scroll)
+     */
+    void Update(SkyBackground& sky)
+    {
+        switch (stage)
+        {
+        case Stage::Reading:
+        {
+            // Um passo do servidor do GFS: nao espera o drive, so copia ate ReadChunkSectors prontos
+            int32_t status = GFS_NwExecOne(file);
+            int32_t mode = 0, arrived = 0;
+            GFS_NwGetStat(file, &mode, &arrived);
+            if (arrived > 0) readOffset = (uint32_t)arrived < fileSize ? (uint32_t)arrived : fileSize;
+
+            if (status == GFS_SVR_ERROR || (status == GFS_SVR_COMPLETED && readOffset < fileSize))
+            {
+                SRL::Debug::Print(1, 13, "Sky swap: erro de leitura");
+                CloseFile();
+                stage = Stage::Idle;
+                break;
+            }
+
+            if (status == GFS_SVR_COMPLETED)
+            {
+                CloseFile();
+
+                if (packed)
+                {
+                    // .SKY: ja esta no layout do VDP2, vai direto para o upload
+                    if (!UsePacked())
+                    {
+                        SRL::Debug::Print(1, 13, "Sky swap: .SKY invalido");
+                        stage = Stage::Idle;
+                        break;
+                    }
+                    if (ChooseTarget()) StartUpload();
+                    else stage = Stage::Idle;
+                    break;
+                }
+
+                convertDone = false;
+                convertOk = false;
+                stage = Stage::Converting;
+                slSlaveFunc(ConvertOnSlave, this);
+            }
+            break;
+        }
+
+        case Stage::Converting:
+            if (!SlaveFinished()) break;
+            slCashPurge();
+            if (!convertOk)
+            {
+                SRL::Debug::Print(1, 13, "Sky swap: formato invalido");
+                stage = Stage::Idle;
+                break;
+            }
+            UseConverted();
+            if (ChooseTarget()) StartUpload();
+            else stage = Stage::Idle;
+            break;
+
+        case Stage::FadingOut:
+            if (fadeRate < FadeStart)
+            {
+                fadeRate = fadeRate + FadeStep < FadeStart ? (uint8_t)(fadeRate + FadeStep) : FadeStart;
+                slColRateNbg0(fadeRate);
+                break;
+            }
+            // Regiao da frente vai ser sobrescrita: NBG0 desligado ate o fim do upload
+            SRL::VDP2::NBG0::ScrollDisable();
+            stage = Stage::Uploading;
+            break;
+
+        case Stage::Uploading:
+            if (uploadOffset < srcCellCount * SkyTiles::CellBytes + MapRegionBytes) break;
+            if (!fadeThrough)
+            {
+                BeginFade(sky);
+                break;
+            }
+
+            LoadPalette();
+            Commit(sky);
+            slColorCalc(CC_RATE | CC_TOP);
+            slColorCalcOn(NBG0ON);
+            slColRateNbg0(fadeRate);
+            SRL::VDP2::NBG0::ScrollEnable();
+            stage = Stage::FadingIn;
+            break;
+
+        case Stage::FadingIn:
+            if (fadeRate > 0)
+            {
+                fadeRate = fadeRate > FadeStep ? (uint8_t)(fadeRate - FadeStep) : 0;
+                slColRateNbg0(fadeRate);
+                break;
+            }
+            slColorCalcOn(0);
+            stage = Stage::Idle;
+            break;
+
+        case Stage::Fading:
+            SRL::VDP2::NBG1::SetPosition(sky.scroll);
+            if (fadeRate == 0)
+            {
+                Commit(sky);
+                break;
+            }
+            fadeRate--;
+            slColRateNbg1(fadeRate);
+            break;
+
+        default:
+            break;
+        }
+    }
+};
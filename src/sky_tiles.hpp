@@ -0,0 +1,219 @@
+#pragma once
+
+#include <srl.hpp>
+#include "work_ram.hpp"
+
+// Ceu ja no formato nativo do VDP2: celulas 8x8 256 cores (sem repeticao), mapa de nomes
+// de padrao 64x64 (1 word) e paleta RGB555. Mesmo layout do .SKY gerado por tools/sky2vdp2;
+// a conversao em tempo de execucao fica como fallback para TGAs sem .SKY no disco.
+struct SkyTiles
+{
+    static constexpr uint16_t MapSize = 64;          // 1 pagina = 64x64 celulas (512x512 px)
+    static constexpr uint16_t CellBytes = 64;        // 8x8 @ 8bpp
+    static constexpr uint16_t MaxCells = 2048;       // 128 KB de celulas unicas (um banco)
+    static constexpr uint16_t HashSize = 4096;
+    static constexpr uint16_t EmptySlot = 0xffff;
+
+    uint8_t* cells = nullptr;      // MaxCells * CellBytes
+    uint16_t* map = nullptr;       // MapSize * MapSize, numero de celula (indice * 2)
+    uint8_t* rowCells = nullptr;   // uma linha de celulas em montagem
+    uint16_t* hashTable = nullptr; // deduplicacao de celulas
+    uint16_t palette[256] = {};
+    uint16_t cellCount = 0;
+    uint16_t width = 0;
+    uint16_t height = 0;
+    bool valid = false;
+
+    ~SkyTiles()
+    {
+        WorkRam::Free(cells);
+        delete[] map;
+        delete[] rowCells;
+        delete[] hashTable;
+    }
+
+    // Aloca tudo antes: a conversao pode rodar no escravo, onde o heap nao e seguro
+    void Allocate()
+    {
+        if (cells == nullptr) cells = (uint8_t*)WorkRam::Allocate("sky cells", WorkRam::Region::Low, MaxCells * CellBytes); // escrita na conversao, lida pelo DMA
+        if (map == nullptr) map = new uint16_t[MapSize * MapSize];
+        if (rowCells == nullptr) rowCells = new uint8_t[MapSize * CellBytes];
+        if (hashTable == nullptr) hashTable = new uint16_t[HashSize];
+    }
+
+    static uint32_t HashCell(const uint8_t* cell)
+    {
+        uint32_t h = 2166136261u;
+        for (uint16_t i = 0; i < CellBytes; ++i)
+        {
+            h ^= cell[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    static bool SameCell(const uint8_t* a, const uint8_t* b)
+    {
+        const uint32_t* wa = (const uint32_t*)a;
+        const uint32_t* wb = (const uint32_t*)b;
+        for (uint16_t i = 0; i < CellBytes / 4; ++i)
+        {
+            if (wa[i] != wb[i]) return false;
+        }
+        return true;
+    }
+
+    /** @brief Converte um TGA 8bpp paletizado (tipo 1 ou 9/RLE) que esta em memoria
+     * @note Nao acessa CD nem VDP2: seguro para o SH-2 escravo
+     * @param data Conteudo do arquivo
+     * @param size Tamanho em bytes
+     * @return true se a imagem cabe no formato (ate 512x512, ate MaxCells celulas unicas)
+     */
+    bool ConvertTga(const uint8_t* data, uint32_t size)
+    {
+        valid = false;
+        cellCount = 0;
+        if (data == nullptr || size < 18 || cells == nullptr || map == nullptr || rowCells == nullptr || hashTable == nullptr) return false;
+
+        uint8_t idLength = data[0];
+        uint8_t colorMapType = data[1];
+        uint8_t imageType = data[2];
+        uint16_t colorMapFirst = data[3] | (data[4] << 8);
+        uint16_t colorMapLength = data[5] | (data[6] << 8);
+        uint8_t colorMapBits = data[7];
+        width = data[12] | (data[13] << 8);
+        height = data[14] | (data[15] << 8);
+        uint8_t bpp = data[16];
+        bool topDown = (data[17] & 0x20) != 0;
+
+        if (colorMapType != 1 || (imageType != 1 && imageType != 9) || bpp != 8) return false;
+        if ((width & 7) != 0 || (height & 7) != 0 || width > MapSize * 8 || height > MapSize * 8) return false;
+
+        // Paleta BGR(A) -> RGB555
+        const uint8_t* iterator = data + 18 + idLength;
+        uint8_t entryBytes = colorMapBits / 8;
+        for (uint16_t i = 0; i < 256; ++i) palette[i] = 0;
+        for (uint16_t i = 0; i < colorMapLength && (colorMapFirst + i) < 256; ++i)
+        {
+            const uint8_t* c = iterator + i * entryBytes;
+            palette[colorMapFirst + i] = 0x8000 | ((c[2] >> 3) << 0) | ((c[1] >> 3) << 5) | ((c[0] >> 3) << 10);
+        }
+        iterator += colorMapLength * entryBytes;
+
+        // Linha de celulas (8 linhas da imagem) montada em rowCells
+        const uint16_t cellsPerRow = width / 8;
+        for (uint16_t i = 0; i < HashSize; ++i) hashTable[i] = EmptySlot;
+
+        const uint8_t* end = data + size;
+        uint8_t runValue = 0;
+        uint16_t runLeft = 0;
+        bool runIsRaw = false;
+        bool ok = true;
+
+        for (uint16_t cellY = 0; cellY < height / 8 && ok; ++cellY)
+        {
+            for (uint16_t line = 0; line < 8 && ok; ++line)
+            {
+                // Linhas lidas na ordem do arquivo; origem embaixo e corrigida por celula abaixo
+                for (uint16_t x = 0; x < width; ++x)
+                {
+                    uint8_t pixel;
+                    if (imageType == 1)
+                    {
+                        if (iterator >= end) { ok = false; break; }
+                        pixel = *iterator++;
+                    }
+                    else
+                    {
+                        if (runLeft == 0)
+                        {
+                            if (iterator >= end) { ok = false; break; }
+                            uint8_t header = *iterator++;
+                            runIsRaw = (header & 0x80) == 0;
+                            runLeft = (header & 0x7f) + 1;
+                            if (!runIsRaw)
+                            {
+                                if (iterator >= end) { ok = false; break; }
+                                runValue = *iterator++;
+                            }
+                        }
+
+                        if (runIsRaw)
+                        {
+                            if (iterator >= end) { ok = false; break; }
+                            pixel = *iterator++;
+                        }
+                        else
+                        {
+                            pixel = runValue;
+                        }
+                        runLeft--;
+                    }
+
+                    rowCells[(x >> 3) * CellBytes + (line << 3) + (x & 7)] = pixel;
+                }
+            }
+
+            if (!ok) break;
+
+            // Imagem de baixo para cima: a faixa lida corresponde a linha de celulas espelhada
+            uint16_t mapY = topDown ? cellY : (height / 8 - 1 - cellY);
+            for (uint16_t cellX = 0; cellX < cellsPerRow; ++cellX)
+            {
+                uint8_t* cell = rowCells + cellX * CellBytes;
+                if (!topDown)
+                {
+                    // Inverte as 8 linhas da celula
+                    for (uint16_t l = 0; l < 4; ++l)
+                    {
+                        uint32_t* a = (uint32_t*)(cell + l * 8);
+                        uint32_t* b = (uint32_t*)(cell + (7 - l) * 8);
+                        uint32_t t0 = a[0], t1 = a[1];
+                        a[0] = b[0]; a[1] = b[1];
+                        b[0] = t0; b[1] = t1;
+                    }
+                }
+
+                uint16_t slot = HashCell(cell) & (HashSize - 1);
+                uint16_t index = EmptySlot;
+                while (hashTable[slot] != EmptySlot)
+                {
+                    if (SameCell(cells + hashTable[slot] * CellBytes, cell))
+                    {
+                        index = hashTable[slot];
+                        break;
+                    }
+                    slot = (slot + 1) & (HashSize - 1);
+                }
+
+                if (index == EmptySlot)
+                {
+                    if (cellCount >= MaxCells) { ok = false; break; }
+                    index = cellCount++;
+                    uint32_t* dst = (uint32_t*)(cells + index * CellBytes);
+                    const uint32_t* src = (const uint32_t*)cell;
+                    for (uint16_t i = 0; i < CellBytes / 4; ++i) dst[i] = src[i];
+                    hashTable[slot] = index;
+                }
+
+                map[mapY * MapSize + cellX] = (uint16_t)(index * 2);
+            }
+        }
+
+        if (!ok) return false;
+
+        // Repete a imagem para preencher a pagina 64x64 (mesmo periodo do scroll)
+        const uint16_t rows = height / 8;
+        for (uint16_t y = 0; y < MapSize; ++y)
+        {
+            for (uint16_t x = 0; x < MapSize; ++x)
+            {
+                if (y < rows && x < cellsPerRow) continue;
+                map[y * MapSize + x] = map[(y % rows) * MapSize + (x % cellsPerRow)];
+            }
+        }
+
+        valid = true;
+        return true;
+    }
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <srl.hpp>
+#include "video_mode.hpp"
+
+// Tela dividida para dois jogadores. Cada viewport e uma janela do SGL (slWindow): clipping de usuario
+// da VDP1 e centro de projecao proprios, com a mesma distancia focal da tela cheia, entao cada metade mostra
+// a faixa central da vista de um jogador. Pista, carro e texturas sao os mesmos; so o culling e o
+// detalhe rodam por viewport. No VDP2 a janela 0 cobre o viewport 0 e separa os ceus (NBG0/NBG1).
+struct SplitScreen
+{
+    static constexpr uint8_t MaxViews = 2;
+    static constexpr uint8_t SplitBias = 2; // vies de detalhe a mais por viewport: soma fica perto de uma tela
+
+    enum class Layout : uint8_t
+    {
+        Single,
+        Stacked,    // jogador 1 em cima, 2 embaixo
+        SideBySide, // jogador 1 a esquerda
+    };
+
+    struct Viewport
+    {
+        int16_t left;
+        int16_t top;
+        int16_t right;
+        int16_t bottom;
+    };
+
+    Layout layout = Layout::Single;
+
+    uint8_t Count() const
+    {
+        return layout == Layout::Single ? 1 : MaxViews;
+    }
+
+    bool Active() const
+    {
+        return layout != Layout::Single;
+    }
+
+    Viewport Rect(uint8_t view, const VideoMode& video) const
+    {
+        const int16_t width = VideoMode::Width;
+        const int16_t height = (int16_t)video.height;
+        switch (layout)
+        {
+        case Layout::Stacked:
+            return view == 0 ? Viewport{0, 0, width - 1, height / 2 - 1} : Viewport{0, height / 2, width - 1, height - 1};
+        case Layout::SideBySide:
+            return view == 0 ? Viewport{0, 0, width / 2 - 1, height - 1} : Viewport{width / 2, 0, width - 1, height - 1};
+        default:
+            return Viewport{0, 0, width - 1, height - 1};
+        }
+    }
+
+    /** @brief Linhas do ceu (imagem) que o viewport desloca para o horizonte ficar no centro dele
+     * @note Em linhas da imagem: no 448i o NBG0 ja esta ampliado 2x
+     */
+    int32_t SkyRowOffset(uint8_t view) const
+    {
+        if (layout != Layout::Stacked) return 0;
+        return view == 0 ? VideoMode::LowHeight / 4 : -(int32_t)VideoMode::LowHeight / 4;
+    }
+
+    /** @brief Linha da tabela de line scroll do ceu onde o viewport 1 comeca
+     * @return 0 fora do empilhado (lado a lado as linhas sao dos dois viewports)
+     */
+    uint16_t SkySecondLine() const
+    {
+        return layout == Layout::Stacked ? VideoMode::LowHeight / 2 : 0;
+    }
+
+    // Passa para o proximo arranjo (Single -> Stacked -> SideBySide -> Single)
+    Layout Next()
+    {
+        layout = (Layout)(((uint8_t)layout + 1) % 3);
+        return layout;
+    }
+
+    /** @brief Janela do viewport para o que for desenhado a seguir (VDP1 e projecao)
+     */
+    void Begin(uint8_t view, const VideoMode& video) const
+    {
+        Viewport rect = Rect(view, video);
+        slWindow(rect.left, rect.top, rect.right, rect.bottom, 0x7fff, (rect.left + rect.right + 1) / 2, (rect.top + rect.bottom + 1) / 2);
+    }
+
+    // Volta para a tela cheia (HUD em 2D e quadro seguinte)
+    void End(const VideoMode& video) const
+    {
+        if (Active()) slWindow(0, 0, VideoMode::Width - 1, video.height - 1, 0x7fff, VideoMode::Width / 2, video.height / 2);
+    }
+
+    /** @brief Janela 0 do VDP2 no viewport 0; a janela marca onde a camada fica transparente:
+     * NBG0 some fora dela e NBG1 dentro
+     */
+    void ApplyBackground(const VideoMode& video) const
+    {
+        if (!Active())
+        {
+            slScrWindowModeNbg0(0);
+            slScrWindowModeNbg1(0);
+            return;
+        }
+
+        Viewport rect = Rect(0, video);
+        slScrWindow0(rect.left, rect.top, rect.right, rect.bottom);
+        slScrWindowModeNbg0(win0_OUT);
+        slScrWindowModeNbg1(win0_IN);
+    }
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <srl.hpp>
+
+// Texturas VDP1 ja enviadas, indexadas pelo conteudo (tamanho + pixels).
+// Uma imagem igual a outra ja carregada, no mesmo modelo ou em outro, reaproveita o slot:
+// nao ocupa VRAM de novo nem passa pelo upload.
+namespace TextureCache
+{
+    constexpr size_t MaxEntries = 1024;    // >= SRL_MAX_TEXTURES
+    constexpr size_t TableSize = 2048;     // potencia de 2, > MaxEntries
+    constexpr uint16_t EmptySlot = 0xffff;
+
+    struct Entry
+    {
+        uint32_t hash;  // FNV-1a dos pixels
+        uint32_t check; // soma de Fletcher, segunda chave contra colisao
+        uint16_t width;
+        uint16_t height;
+        uint16_t slot;  // indice da textura na VDP1
+    };
+
+    inline Entry entries[MaxEntries];
+    inline uint16_t table[TableSize];
+    inline size_t entryCount = 0;
+    inline size_t reused = 0; // uploads evitados desde o ultimo Reset
+    inline bool ready = false;
+
+    /** @brief Esquece todas as texturas (chamar junto com a liberacao da VRAM da VDP1)
+     */
+    inline void Reset()
+    {
+        for (size_t i = 0; i < TableSize; ++i) table[i] = EmptySlot;
+        entryCount = 0;
+        reused = 0;
+        ready = true;
+    }
+
+    inline void Hash(const SRL::Types::HighColor* pixels, size_t count, uint32_t& hash, uint32_t& check)
+    {
+        const uint16_t* words = (const uint16_t*)pixels;
+        uint32_t low = 0, high = 0;
+        hash = 2166136261u;
+        for (size_t i = 0; i < count; ++i)
+        {
+            hash = (hash ^ words[i]) * 16777619u;
+            low = (low + words[i]) % 65535;
+            high = (high + low) % 65535;
+        }
+        check = (high << 16) | low;
+    }
+
+    /** @brief Slot da VDP1 para a imagem, enviando so se o conteudo ainda nao existir
+     * @return Indice da textura ou -1 se nao coube
+     */
+    inline int32_t Load(uint16_t width, uint16_t height, SRL::Types::HighColor* pixels)
+    {
+        if (!ready) Reset();
+
+        uint32_t hash, check;
+        Hash(pixels, (size_t)width * height, hash, check);
+        hash ^= ((uint32_t)width << 16) | height;
+
+        uint32_t position = hash & (TableSize - 1);
+        while (table[position] != EmptySlot)
+        {
+            const Entry& e = entries[table[position]];
+            if (e.hash == hash && e.check == check && e.width == width && e.height == height)
+            {
+                reused++;
+                return e.slot;
+            }
+            position = (position + 1) & (TableSize - 1);
+        }
+
+        int32_t slot = SRL::VDP1::TryLoadTexture(width, height, SRL::CRAM::TextureColorMode::RGB555, 0, pixels);
+        if (slot < 0 || entryCount >= MaxEntries) return slot;
+
+        entries[entryCount] = Entry{hash, check, width, height, (uint16_t)slot};
+        table[position] = (uint16_t)entryCount++;
+        return slot;
+    }
+} // namespace TextureCache
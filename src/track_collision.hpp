@@ -0,0 +1,200 @@
+#pragma once
+
+#include <srl.hpp>
+#include "modelObject.hpp"
+#include "work_ram.hpp"
+
+// Indice de colisao da pista: grade 2D no plano XZ com altura do chao e marca de parede por celula.
+// Coordenadas ja no espaco do mundo (malha da pista desenhada com RotateX(180): Y e Z invertidos, Y+ para baixo).
+struct TrackCollision
+{
+    static constexpr int32_t CellShift = 4;           // celula de 16 unidades
+    static constexpr int32_t CellSize = 1 << CellShift;
+    static constexpr int32_t MaxCells = 128 * 96;     // pista atual: ~101x74 celulas
+
+    enum CellFlags : uint8_t
+    {
+        Surface = 1 << 0, // tem chao
+        Wall = 1 << 1,    // cruzada por face vertical (muro, predio, arquibancada)
+    };
+
+    struct Cell
+    {
+        int16_t groundY; // altura do chao (Y do mundo, menor = mais alto)
+        uint8_t flags;
+        uint8_t reserved;
+    };
+
+    Cell* cells = nullptr;
+    int32_t originX = 0; // canto da grade em unidades inteiras do mundo
+    int32_t originZ = 0;
+    int32_t columns = 0;
+    int32_t rows = 0;
+    bool ready = false;
+
+    ~TrackCollision()
+    {
+        delete[] cells;
+    }
+
+    static SRL::Math::Types::Vector3D ToWorld(const SRL::Math::Types::Vector3D& p)
+    {
+        return SRL::Math::Types::Vector3D(p.X, -p.Y, -p.Z);
+    }
+
+    Cell* At(int32_t column, int32_t row) const
+    {
+        if (column < 0 || row < 0 || column >= columns || row >= rows) return nullptr;
+        return &cells[row * columns + column];
+    }
+
+    Cell* AtWorld(int32_t x, int32_t z) const
+    {
+        return At((x - originX) >> CellShift, (z - originZ) >> CellShift);
+    }
+
+    /** @brief Monta a grade a partir das malhas da pista (uma vez, no load)
+     * @param track Pista carregada (INTLAGOS.NYA, malhas smooth)
+     */
+    WORKRAM_COLD bool Build(ModelObject& track)
+    {
+        ready = false;
+        if (!track.IsSmooth() || track.GetMeshCount() == 0) return false;
+
+        // Limites XZ de toda a pista
+        int32_t minX = INT32_MAX, minZ = INT32_MAX, maxX = INT32_MIN, maxZ = INT32_MIN;
+        for (size_t m = 0; m < track.GetMeshCount(); ++m)
+        {
+            auto* mesh = track.GetMesh<SRL::Types::SmoothMesh>(m);
+            for (size_t v = 0; v < mesh->VertexCount; ++v)
+            {
+                auto p = ToWorld(mesh->Vertices[v]);
+                int32_t x = p.X.As<int32_t>();
+                int32_t z = p.Z.As<int32_t>();
+                if (x < minX) minX = x;
+                if (x > maxX) maxX = x;
+                if (z < minZ) minZ = z;
+                if (z > maxZ) maxZ = z;
+            }
+        }
+
+        originX = minX - CellSize;
+        originZ = minZ - CellSize;
+        columns = ((maxX - originX) >> CellShift) + 2;
+        rows = ((maxZ - originZ) >> CellShift) + 2;
+        if (columns * rows > MaxCells)
+        {
+            SRL::Debug::Print(1, 13, "Colisao: pista grande demais (%dx%d)", (int)columns, (int)rows);
+            return false;
+        }
+
+        delete[] cells;
+        cells = new Cell[columns * rows];
+        for (int32_t i = 0; i < columns * rows; ++i) cells[i] = Cell{INT16_MAX, 0, 0};
+
+        for (size_t m = 0; m < track.GetMeshCount(); ++m)
+        {
+            auto* mesh = track.GetMesh<SRL::Types::SmoothMesh>(m);
+            for (size_t f = 0; f < mesh->FaceCount; ++f)
+            {
+                const auto& face = mesh->Faces[f];
+                SRL::Math::Types::Vector3D corners[4];
+                for (size_t i = 0; i < 4; ++i) corners[i] = ToWorld(mesh->Vertices[face.Vertices[i]]);
+
+                // Normal do arquivo tem Y+ para cima; |Y| < 0.5 = face vertical
+                int32_t normalY = face.Normal.Y.RawValue();
+                if (normalY > 0x8000)
+                {
+                    AddGround(corners);
+                }
+                else if (normalY > -0x8000)
+                {
+                    for (size_t i = 0; i < 4; ++i) MarkWallEdge(corners[i], corners[(i + 1) & 3]);
+                }
+            }
+        }
+
+        ready = true;
+        return true;
+    }
+
+    // Chao: caixa XZ da face recebe a altura mais alta que a cobre
+    void AddGround(const SRL::Math::Types::Vector3D* corners)
+    {
+        int32_t minX = INT32_MAX, minZ = INT32_MAX, maxX = INT32_MIN, maxZ = INT32_MIN, topY = INT32_MAX;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            int32_t x = corners[i].X.As<int32_t>();
+            int32_t y = corners[i].Y.As<int32_t>();
+            int32_t z = corners[i].Z.As<int32_t>();
+            if (x < minX) minX = x;
+            if (x > maxX) maxX = x;
+            if (z < minZ) minZ = z;
+            if (z > maxZ) maxZ = z;
+            if (y < topY) topY = y;
+        }
+
+        for (int32_t row = (minZ - originZ) >> CellShift; row <= (maxZ - originZ) >> CellShift; ++row)
+        {
+            for (int32_t column = (minX - originX) >> CellShift; column <= (maxX - originX) >> CellShift; ++column)
+            {
+                Cell* cell = At(column, row);
+                if (cell == nullptr) continue;
+                cell->flags |= Surface;
+                if (topY < cell->groundY) cell->groundY = (int16_t)topY;
+            }
+        }
+    }
+
+    // Parede: marca as celulas percorridas pela aresta no plano XZ
+    void MarkWallEdge(const SRL::Math::Types::Vector3D& a, const SRL::Math::Types::Vector3D& b)
+    {
+        int32_t ax = a.X.As<int32_t>(), az = a.Z.As<int32_t>();
+        int32_t bx = b.X.As<int32_t>(), bz = b.Z.As<int32_t>();
+        int32_t dx = bx - ax, dz = bz - az;
+        int32_t length = (dx < 0 ? -dx : dx) > (dz < 0 ? -dz : dz) ? (dx < 0 ? -dx : dx) : (dz < 0 ? -dz : dz);
+        int32_t steps = (length >> (CellShift - 1)) + 1; // meia celula por passo
+
+        for (int32_t i = 0; i <= steps; ++i)
+        {
+            Cell* cell = AtWorld(ax + dx * i / steps, az + dz * i / steps);
+            if (cell != nullptr) cell->flags |= Wall;
+        }
+    }
+
+    /** @brief Altura do chao (Y do mundo) sob um ponto
+     * @return false fora da pista
+     */
+    WORKRAM_HOT bool GroundHeight(const SRL::Math::Types::Vector3D& point, SRL::Math::Types::Fxp& groundY) const
+    {
+        if (!ready) return false;
+        const Cell* cell = AtWorld(point.X.As<int32_t>(), point.Z.As<int32_t>());
+        if (cell == nullptr || (cell->flags & Surface) == 0) return false;
+        groundY = SRL::Math::Types::Fxp::Convert(cell->groundY);
+        return true;
+    }
+
+    /** @brief Anda de 'from' ate 'to' e para antes da primeira celula de parede
+     * @return Ultimo ponto livre do segmento
+     */
+    WORKRAM_HOT SRL::Math::Types::Vector3D ClampSegment(const SRL::Math::Types::Vector3D& from, const SRL::Math::Types::Vector3D& to) const
+    {
+        if (!ready) return to;
+
+        SRL::Math::Types::Vector3D delta = to - from;
+        int32_t dx = delta.X.As<int32_t>(), dz = delta.Z.As<int32_t>();
+        int32_t length = (dx < 0 ? -dx : dx) + (dz < 0 ? -dz : dz);
+        int32_t steps = (length >> (CellShift - 1)) + 1;
+        SRL::Math::Types::Fxp stepFraction = SRL::Math::Types::Fxp::Convert(1) / SRL::Math::Types::Fxp::Convert(steps);
+
+        SRL::Math::Types::Vector3D last = from;
+        for (int32_t i = 1; i <= steps; ++i)
+        {
+            SRL::Math::Types::Vector3D point = from + delta * (stepFraction * SRL::Math::Types::Fxp::Convert(i));
+            const Cell* cell = AtWorld(point.X.As<int32_t>(), point.Z.As<int32_t>());
+            if (cell != nullptr && (cell->flags & Wall) != 0) return last;
+            last = point;
+        }
+        return to;
+    }
+};
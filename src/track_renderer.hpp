@@ -0,0 +1,510 @@
+#pragma once
+
+#include <srl.hpp>
+#include <vector>
+#include "cd_directory.hpp"
+#include "depth_fog.hpp"
+#include "face_culling.hpp"
+#include "ground_plane.hpp"
+#include "modelObject.hpp"
+#include "track_sprites.hpp"
+#include "work_ram.hpp"
+
+// Desenho da pista por segmento. A ordem do circuito vem do INTLAGOS.MST (linha i = malha i, "pista_seg.NNN"):
+// so uma janela de segmentos em volta do carro e submetida, do mais distante para o mais proximo,
+// e o Z-sort do SGL so desempata dentro dessa ordem grossa.
+struct TrackRenderer
+{
+    static constexpr size_t MaxSegments = 384;
+    static constexpr size_t MaxTextures = 64;
+    static constexpr uint16_t NoSegment = 0xffff;
+    static constexpr uint16_t SearchRadius = 8; // busca local do segmento do carro
+    static constexpr uint8_t MaxViews = 2;      // tela dividida: um carro/camera por viewport
+
+    // Decalques planos sobre o asfalto (nomes do INTLAGOS.MAP, um por linha, na ordem das texturas do NYA)
+    static constexpr const char* DecalTextures[] = {
+        "faixa_amarela_64",
+        "Zebra_64",
+    };
+
+    // Cenario em pe desenhado como sprite (TrackSprites); nomes ausentes no MAP sao ignorados
+    static constexpr const char* SpriteTextures[] = {
+        "arvore_3_64",
+        "arvore_low_poly_64",
+        "arvores_reta_1_64",
+        "arvores_reta_2_64",
+        "mato_3_64",
+        "placa_100_64",
+        "placa_150_64",
+        "velocidade_50_64",
+        "torcida_64",
+    };
+
+    // Pisos com faces grandes: recortados em 2x2/4x4 para a divisao perto da camera (NearSubdivision)
+    static constexpr const char* SplitTextures[] = {
+        "asfalto_64",
+        "grama-verde-foto_64",
+        "grama_lugar_alto_64",
+        "grama_lateral_64",
+    };
+
+    // Teto sobre a pista (face virada para baixo): o carro usa o preset de luz de tunel nesses segmentos
+    static constexpr const char* CoverTextures[] = {
+        "teto_64",
+    };
+
+    static constexpr int32_t NearRange = 128; // centro do segmento ate o olho: faces passam pela divisao/corte
+
+    struct Window
+    {
+        uint16_t ahead = 48;
+        uint16_t behind = 12;
+    };
+
+    ModelObject& track;
+    FaceCulling culling;
+    TrackSprites sprites;
+    DepthFog fog;
+    NearSubdivision near;
+    Window window;
+    uint16_t segmentCount = 0;
+    uint16_t meshOfSegment[MaxSegments]; // ordem do circuito -> malha
+    int16_t centerX[MaxSegments];         // centro XZ do segmento no mundo
+    int16_t centerZ[MaxSegments];
+    uint16_t drawList[MaxSegments];
+    uint8_t drawFog[MaxSegments];         // nivel de neblina de cada entrada de drawList
+    bool drawNear[MaxSegments];
+    bool covered[MaxSegments] = {};
+    uint16_t drawCount = 0;
+    uint16_t carSegment = NoSegment;
+    uint8_t detail = 0; // vies do FrameGovernor
+    uint16_t viewCarSegment[MaxViews] = {NoSegment, NoSegment};
+    uint8_t view = 0;
+    bool isDecal[MaxTextures] = {};
+    bool isSprite[MaxTextures] = {};
+    bool isSplit[MaxTextures] = {};
+    bool isCover[MaxTextures] = {};
+    bool isGround[MaxTextures] = {};
+    bool ready = false;
+
+    explicit TrackRenderer(ModelObject& trackModel) : track(trackModel) {}
+
+    // Arquivo texto inteiro na memoria (terminado em '\0')
+    static char* LoadText(const char* const* paths, size_t count)
+    {
+        const char* path = CdDirectory::ResolvePath(paths, count);
+        if (path == nullptr) return nullptr;
+
+        SRL::Cd::File file(path);
+        if (file.Size.Bytes <= 0) return nullptr;
+
+        char* text = (char*)WorkRam::Allocate("track text", WorkRam::Region::Low, file.Size.Bytes + 1);
+        if (text == nullptr || file.LoadBytes(0, file.Size.Bytes, text) <= 0)
+        {
+            WorkRam::Free(text);
+            return nullptr;
+        }
+        text[file.Size.Bytes] = '\0';
+        return text;
+    }
+
+    static bool SameName(const char* a, const char* b, size_t length)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            if (a[i] != b[i] || a[i] == '\0') return false;
+        }
+        return b[length] == '\0';
+    }
+
+    /** @brief Le ordem dos segmentos e nomes das texturas e prepara a ordenacao das faces
+     * @param groundPlane Chao RBG0 carregado: faces de grama que ele cobre (GroundPlane::Covers) saem da malha
+     * @note Chamar uma vez depois de carregar a pista
+     */
+    WORKRAM_COLD bool Load(const char* const* orderPaths, size_t orderCount, const char* const* mapPaths, size_t mapCount, bool groundPlane = false)
+    {
+        ready = false;
+        if (!track.IsSmooth() || track.GetMeshCount() == 0 || track.GetMeshCount() > MaxSegments) return false;
+
+        char* order = LoadText(orderPaths, orderCount);
+        if (order == nullptr)
+        {
+            SRL::Debug::Print(1, 13, "Pista: MST nao encontrado");
+            return false;
+        }
+
+        // "malha;pista_seg.NNN;texturas" -> numero do segmento por malha
+        uint16_t meshCount = (uint16_t)track.GetMeshCount();
+        std::vector<uint16_t> segmentNumber(meshCount, NoSegment);
+        for (char* line = order; *line != '\0';)
+        {
+            int32_t mesh = 0;
+            char* p = line;
+            while (*p >= '0' && *p <= '9') mesh = mesh * 10 + (*p++ - '0');
+
+            // Numero depois do ultimo '.' do nome
+            int32_t number = -1;
+            if (*p == ';')
+            {
+                for (++p; *p != ';' && *p != '\n' && *p != '\0'; ++p)
+                {
+                    if (*p == '.') number = 0;
+                    else if (number >= 0 && *p >= '0' && *p <= '9') number = number * 10 + (*p - '0');
+                }
+            }
+            if (mesh < meshCount && number >= 0) segmentNumber[mesh] = (uint16_t)number;
+
+            while (*p != '\n' && *p != '\0') ++p;
+            line = *p == '\n' ? p + 1 : p;
+        }
+        WorkRam::Free(order);
+
+        // Malhas ordenadas pelo numero do segmento (insercao: roda uma vez no load)
+        segmentCount = 0;
+        for (uint16_t mesh = 0; mesh < meshCount; ++mesh)
+        {
+            if (segmentNumber[mesh] == NoSegment) continue;
+
+            uint16_t slot = segmentCount++;
+            while (slot > 0 && segmentNumber[meshOfSegment[slot - 1]] > segmentNumber[mesh])
+            {
+                meshOfSegment[slot] = meshOfSegment[slot - 1];
+                --slot;
+            }
+            meshOfSegment[slot] = mesh;
+        }
+
+        LoadTextureNames(mapPaths, mapCount);
+
+        for (uint16_t segment = 0; segment < segmentCount; ++segment)
+        {
+            auto* mesh = track.GetMesh<SRL::Types::SmoothMesh>(meshOfSegment[segment]);
+            ComputeCenter(*mesh, segment);
+            covered[segment] = HasCover(*mesh);
+            sprites.Extract(*mesh, meshOfSegment[segment], [this](const ATTR& attr) { return UsesTexture(isSprite, attr); });
+            if (groundPlane) DropGround(*mesh);
+            PrepareSorting(*mesh);
+        }
+
+        // Planos e cones depois da reordenacao dos decalques e sem as faces que viraram sprite
+        culling.Build(track);
+        for (size_t texture = 0; texture < MaxTextures; ++texture)
+        {
+            if (isSplit[texture]) near.AddTexture(track, texture);
+        }
+
+        carSegment = NoSegment;
+        for (uint16_t& segment : viewCarSegment) segment = NoSegment;
+        view = 0;
+        ready = segmentCount > 0;
+        return ready;
+    }
+
+    void LoadTextureNames(const char* const* mapPaths, size_t mapCount)
+    {
+        char* names = LoadText(mapPaths, mapCount);
+        if (names == nullptr) return;
+
+        size_t texture = 0;
+        for (char* line = names; *line != '\0' && texture < MaxTextures; ++texture)
+        {
+            size_t length = 0;
+            while (line[length] != '\n' && line[length] != '\r' && line[length] != '\0') ++length;
+
+            for (const char* decal : DecalTextures)
+            {
+                if (SameName(line, decal, length)) isDecal[texture] = true;
+            }
+            for (const char* sprite : SpriteTextures)
+            {
+                if (SameName(line, sprite, length)) isSprite[texture] = true;
+            }
+            for (const char* split : SplitTextures)
+            {
+                if (SameName(line, split, length)) isSplit[texture] = true;
+            }
+            for (const char* cover : CoverTextures)
+            {
+                if (SameName(line, cover, length)) isCover[texture] = true;
+            }
+            if (GroundPlane::Covers(line, length)) isGround[texture] = true;
+
+            line += length;
+            while (*line == '\r' || *line == '\n') ++line;
+        }
+        WorkRam::Free(names);
+    }
+
+    // Tira as faces de chao (viradas para cima) que o RBG0 ja desenha; compacta como o TrackSprites::Extract
+    void DropGround(SRL::Types::SmoothMesh& mesh) const
+    {
+        size_t kept = 0;
+        for (size_t f = 0; f < mesh.FaceCount; ++f)
+        {
+            if (mesh.Faces[f].Normal.Y.RawValue() > 0x8000 && UsesTexture(isGround, *(const ATTR*)&mesh.Attributes[f])) continue;
+            mesh.Faces[kept] = mesh.Faces[f];
+            mesh.Attributes[kept] = mesh.Attributes[f];
+            ++kept;
+        }
+        mesh.FaceCount = kept;
+    }
+
+    void ComputeCenter(const SRL::Types::SmoothMesh& mesh, uint16_t segment)
+    {
+        int32_t minX = INT32_MAX, minZ = INT32_MAX, maxX = INT32_MIN, maxZ = INT32_MIN;
+        for (size_t v = 0; v < mesh.VertexCount; ++v)
+        {
+            int32_t x = mesh.Vertices[v].X.As<int32_t>();
+            int32_t z = -mesh.Vertices[v].Z.As<int32_t>(); // mundo = RotateX(180)
+            if (x < minX) minX = x;
+            if (x > maxX) maxX = x;
+            if (z < minZ) minZ = z;
+            if (z > maxZ) maxZ = z;
+        }
+        centerX[segment] = mesh.VertexCount > 0 ? (int16_t)((minX + maxX) / 2) : 0;
+        centerZ[segment] = mesh.VertexCount > 0 ? (int16_t)((minZ + maxZ) / 2) : 0;
+    }
+
+    // Normal do arquivo com Y+ para cima: Y abaixo de -0.5 = face olhando para o chao
+    bool HasCover(const SRL::Types::SmoothMesh& mesh) const
+    {
+        for (size_t f = 0; f < mesh.FaceCount; ++f)
+        {
+            if (mesh.Faces[f].Normal.Y.RawValue() < -0x8000 && UsesTexture(isCover, *(const ATTR*)&mesh.Attributes[f])) return true;
+        }
+        return false;
+    }
+
+    bool CarCovered() const
+    {
+        return carSegment != NoSegment && covered[carSegment];
+    }
+
+    // Slots podem ser compartilhados (TextureCache): compara pelo slot de cada textura marcada
+    bool UsesTexture(const bool* marked, const ATTR& attr) const
+    {
+        if (attr.texno == No_Texture) return false;
+        for (size_t texture = 0; texture < MaxTextures; ++texture)
+        {
+            if (marked[texture] && track.GetTextureSlot(texture) == attr.texno) return true;
+        }
+        return false;
+    }
+
+    bool IsDecal(const ATTR& attr) const
+    {
+        return UsesTexture(isDecal, attr);
+    }
+
+    // Soma dos 4 cantos (centro * 4) no espaco do arquivo
+    static void FaceCenter(const SRL::Types::SmoothMesh& mesh, size_t face, int32_t* center)
+    {
+        center[0] = center[1] = center[2] = 0;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            const auto& p = mesh.Vertices[mesh.Faces[face].Vertices[i]];
+            center[0] += p.X.As<int32_t>();
+            center[1] += p.Y.As<int32_t>();
+            center[2] += p.Z.As<int32_t>();
+        }
+    }
+
+    // Vies de ordenacao do segmento: chao pelo vertice mais distante (fica atras do que esta em cima dele) e
+    // cada decalque logo depois da face de chao mais proxima com SORT_BFR, desenhado na frente dela
+    void PrepareSorting(SRL::Types::SmoothMesh& mesh)
+    {
+        size_t faceCount = mesh.FaceCount;
+        if (faceCount == 0) return;
+
+        std::vector<int16_t> baseOf(faceCount, -1);
+        bool hasDecal = false;
+        for (size_t f = 0; f < faceCount; ++f)
+        {
+            ATTR& attr = *(ATTR*)&mesh.Attributes[f];
+            if (IsDecal(attr))
+            {
+                attr.sort = (attr.sort & ~3) | SORT_BFR;
+                hasDecal = true;
+            }
+            else if (mesh.Faces[f].Normal.Y.RawValue() > 0x8000)
+            {
+                attr.sort = (attr.sort & ~3) | SORT_MAX; // normal do arquivo com Y+ para cima = chao
+            }
+        }
+        if (!hasDecal) return;
+
+        for (size_t f = 0; f < faceCount; ++f)
+        {
+            if (!IsDecal(*(ATTR*)&mesh.Attributes[f])) continue;
+
+            int32_t decal[3];
+            FaceCenter(mesh, f, decal);
+            int32_t bestDistance = INT32_MAX;
+            for (size_t g = 0; g < faceCount; ++g)
+            {
+                if (IsDecal(*(ATTR*)&mesh.Attributes[g])) continue;
+
+                int32_t base[3];
+                FaceCenter(mesh, g, base);
+                int32_t dx = base[0] - decal[0], dy = base[1] - decal[1], dz = base[2] - decal[2];
+                int32_t distance = dx * dx + dy * dy + dz * dz;
+                if (mesh.Faces[g].Normal.Y.RawValue() <= 0x8000) distance += 1 << 20; // prefere chao
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    baseOf[f] = (int16_t)g;
+                }
+            }
+        }
+
+        // Nova ordem: cada face base seguida dos seus decalques; decalques sem base ficam no fim
+        std::vector<SRL::Types::Polygon> faces(mesh.Faces, mesh.Faces + faceCount);
+        std::vector<SRL::Types::Attribute> attributes(mesh.Attributes, mesh.Attributes + faceCount);
+        size_t next = 0;
+        auto emit = [&](size_t face) {
+            mesh.Faces[next] = faces[face];
+            mesh.Attributes[next] = attributes[face];
+            ++next;
+        };
+
+        for (size_t g = 0; g < faceCount; ++g)
+        {
+            if (IsDecal(*(ATTR*)&attributes[g])) continue;
+            emit(g);
+            for (size_t f = 0; f < faceCount; ++f)
+            {
+                if (baseOf[f] == (int16_t)g) emit(f);
+            }
+        }
+        for (size_t f = 0; f < faceCount; ++f)
+        {
+            if (baseOf[f] < 0 && IsDecal(*(ATTR*)&attributes[f])) emit(f);
+        }
+    }
+
+    static int32_t Distance2(int32_t dx, int32_t dz)
+    {
+        return dx * dx + dz * dz;
+    }
+
+    // Coordenada do carro na pista: segmento de centro mais proximo, buscando em volta do ultimo
+    void UpdateCarSegment(const SRL::Math::Types::Vector3D& carPosition)
+    {
+        int32_t x = carPosition.X.As<int32_t>();
+        int32_t z = carPosition.Z.As<int32_t>();
+
+        uint16_t first = 0, count = segmentCount;
+        if (carSegment != NoSegment && segmentCount > SearchRadius * 2 + 1)
+        {
+            first = (uint16_t)((carSegment + segmentCount - SearchRadius) % segmentCount);
+            count = SearchRadius * 2 + 1;
+        }
+
+        int32_t bestDistance = INT32_MAX;
+        for (uint16_t i = 0; i < count; ++i)
+        {
+            uint16_t segment = (uint16_t)((first + i) % segmentCount);
+            int32_t distance = Distance2(centerX[segment] - x, centerZ[segment] - z);
+            if (distance < bestDistance)
+            {
+                bestDistance = distance;
+                carSegment = segment;
+            }
+        }
+    }
+
+    // Janela do carro, do mais distante (em segmentos) para o mais proximo
+    // Segmentos alem do farClip da neblina ficam fora (o culling nem os ve)
+    void Push(uint16_t segment, int32_t eyeX, int32_t eyeZ)
+    {
+        int32_t dx = centerX[segment] - eyeX, dz = centerZ[segment] - eyeZ;
+        uint8_t level = fog.Level(dx, dz);
+        if (level == DepthFog::Clipped && segment != carSegment) return;
+
+        drawFog[drawCount] = level == DepthFog::Clipped ? DepthFog::Levels : level;
+        drawNear[drawCount] = level == 0 && dx > -NearRange && dx < NearRange && dz > -NearRange && dz < NearRange;
+        drawList[drawCount++] = meshOfSegment[segment];
+    }
+
+    void BuildDrawList(const SRL::Math::Types::Vector3D& eye)
+    {
+        uint16_t behind = window.behind < segmentCount ? window.behind : segmentCount - 1;
+        uint16_t ahead = window.ahead < segmentCount - 1 - behind ? window.ahead : segmentCount - 1 - behind;
+        uint16_t farthest = ahead > behind ? ahead : behind;
+        int32_t eyeX = eye.X.As<int32_t>();
+        int32_t eyeZ = eye.Z.As<int32_t>();
+
+        drawCount = 0;
+        for (uint16_t d = farthest; d > 0; --d)
+        {
+            if (d <= behind) Push((uint16_t)((carSegment + segmentCount - d) % segmentCount), eyeX, eyeZ);
+            if (d <= ahead) Push((uint16_t)((carSegment + d) % segmentCount), eyeX, eyeZ);
+        }
+        Push(carSegment, eyeX, eyeZ);
+    }
+
+    /** @brief Troca o viewport: cada um guarda o segmento do seu carro (a busca local parte dele)
+     * @note Prepare e Render de um viewport antes do Prepare do outro: lista e marcas sao unicas
+     */
+    void BeginView(uint8_t next)
+    {
+        if (next >= MaxViews || next == view) return;
+        viewCarSegment[view] = carSegment;
+        view = next;
+        carSegment = viewCarSegment[view];
+    }
+
+    /** @brief Nivel de detalhe: cada passo tira 1/8 da janela e da distancia da neblina
+     * @param bias 0 = completo; a partir de 2 sem divisao perto da camera
+     */
+    void SetDetail(uint8_t bias)
+    {
+        if (bias == detail) return;
+        detail = bias;
+
+        Window full;
+        DepthFog::Config fullFog;
+        window.ahead = (uint16_t)(full.ahead * (8 - bias) / 8);
+        if (fog.enabled) fog.SetRange(fullFog.fogStart * (8 - bias) / 8, fullFog.farClip * (8 - bias) / 8);
+    }
+
+    /** @brief Escolhe a janela de segmentos e dispara o culling (no escravo, se livre)
+     * @param carPosition Posicao do carro no mundo
+     * @param eye Posicao da camera no mundo (backface no espaco da pista)
+     * @param target Ponto olhado pela camera (plano near)
+     */
+    WORKRAM_HOT void Prepare(const SRL::Math::Types::Vector3D& carPosition, const SRL::Math::Types::Vector3D& eye, const SRL::Math::Types::Vector3D& target)
+    {
+        if (!ready) return;
+
+        UpdateCarSegment(carPosition);
+        BuildDrawList(eye);
+
+        // RotateX(180) e a propria inversa
+        int32_t eyeModel[3] = {eye.X.RawValue(), -eye.Y.RawValue(), -eye.Z.RawValue()};
+        int32_t targetModel[3] = {target.X.RawValue(), -target.Y.RawValue(), -target.Z.RawValue()};
+        near.BeginFrame(eyeModel, targetModel);
+        culling.Kick(track, drawList, drawCount, eyeModel);
+    }
+
+    /** @brief Desenha a janela montada no Prepare
+     * @param light Direcao da luz (mesma do carro)
+     */
+    WORKRAM_HOT void Render(SRL::Math::Types::Vector3D& light)
+    {
+        if (!ready) return;
+
+        culling.Wait();
+        slPushMatrix();
+        slRotX(SRL::Math::Types::Angle::FromDegrees(180.0f).RawValue());
+        culling.BeginFrame();
+        sprites.BeginFrame();
+        for (uint16_t i = 0; i < drawCount; ++i)
+        {
+            if (culling.ready) culling.Draw(track, drawList[i], light, fog.Entry(drawFog[i]), drawNear[i] && near.enabled && detail < 2 ? &near : nullptr, fog.Half(drawFog[i]));
+            else track.Draw(drawList[i], light);
+            sprites.Draw(drawList[i]);
+        }
+        slPopMatrix();
+    }
+};
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <srl.hpp>
+#include <vector>
+#include "work_ram.hpp"
+
+// Cenario de beira de pista (arvores, mato, placas) como sprites distorcidos da VDP1.
+// No load as faces em pe com essas texturas saem das malhas e viram um registro por objeto: dois quads
+// cruzados (arvore em X) viram um sprite sempre de frente para a camera, um painel solto mantem os 4 cantos.
+// Por frame cada objeto custa 2 ou 4 projecoes e um comando de sprite; a profundidade projetada entra no
+// mesmo Z-sort dos poligonos da pista.
+struct TrackSprites
+{
+    static constexpr size_t MaxMeshes = 384;
+    static constexpr int32_t SteepNormal = 0x8000; // |normal.Y| abaixo de 0.5: face em pe
+    static constexpr int32_t NearDepth = 0x10000;  // colado ou atras da camera
+    static constexpr uint8_t FlipH = 1 << 4;       // bits de inversao de ATTR.dir
+    static constexpr uint8_t FlipV = 1 << 5;
+
+    enum class Kind : uint8_t
+    {
+        Facing, // base e topo; largura pela proporcao
+        Fixed,  // cantos da face original
+    };
+
+    struct Sprite
+    {
+        int32_t point[4][3]; // espaco do arquivo; Facing usa [0] = base e [1] = topo
+        int32_t aspect;      // largura / altura em 16.16 (Facing)
+        uint16_t texture;
+        Kind kind;
+        uint8_t flip;
+    };
+
+    std::vector<Sprite> sprites;
+    uint16_t first[MaxMeshes] = {};
+    uint16_t count[MaxMeshes] = {};
+    uint32_t drawn = 0;
+    bool tallPixels = false; // 448i: altura na tela em pixels de meia altura
+
+    static int32_t Abs(int32_t value)
+    {
+        return value < 0 ? -value : value;
+    }
+
+    // Comprimento de (dx, dz) em 16.16 (so no load)
+    static int32_t Length(int32_t dx, int32_t dz)
+    {
+        uint64_t value = (uint64_t)((int64_t)dx * dx) + (uint64_t)((int64_t)dz * dz);
+        uint64_t result = 0;
+        for (uint64_t bit = 1ull << 62; bit != 0; bit >>= 2)
+        {
+            if (value >= result + bit)
+            {
+                value -= result + bit;
+                result = (result >> 1) + bit;
+            }
+            else
+            {
+                result >>= 1;
+            }
+        }
+        return (int32_t)result;
+    }
+
+    static void Bounds(const SRL::Types::SmoothMesh& mesh, size_t face, int32_t* minV, int32_t* maxV)
+    {
+        for (size_t k = 0; k < 3; ++k)
+        {
+            minV[k] = INT32_MAX;
+            maxV[k] = INT32_MIN;
+        }
+        for (size_t i = 0; i < 4; ++i)
+        {
+            const auto& p = mesh.Vertices[mesh.Faces[face].Vertices[i]];
+            int32_t v[3] = {p.X.RawValue(), p.Y.RawValue(), p.Z.RawValue()};
+            for (size_t k = 0; k < 3; ++k)
+            {
+                if (v[k] < minV[k]) minV[k] = v[k];
+                if (v[k] > maxV[k]) maxV[k] = v[k];
+            }
+        }
+    }
+
+    /** @brief Tira da malha as faces de cenario e guarda os sprites do segmento
+     * @param isSprite Predicado sobre o ATTR da face (textura de cenario)
+     * @note Chamar antes de montar o culling: a malha perde essas faces
+     * @return Numero de sprites criados
+     */
+    template<typename IsSprite>
+    WORKRAM_COLD uint16_t Extract(SRL::Types::SmoothMesh& mesh, uint16_t meshId, IsSprite isSprite)
+    {
+        if (meshId >= MaxMeshes) return 0;
+
+        first[meshId] = (uint16_t)sprites.size();
+        count[meshId] = 0;
+        size_t faceCount = mesh.FaceCount;
+        std::vector<uint8_t> taken(faceCount, 0); // 1 = sprite, 2 = ja junto com outra face
+
+        for (size_t f = 0; f < faceCount; ++f)
+        {
+            const ATTR& attr = *(const ATTR*)&mesh.Attributes[f];
+            if (isSprite(attr) && Abs(mesh.Faces[f].Normal.Y.RawValue()) < SteepNormal) taken[f] = 1;
+        }
+
+        for (size_t f = 0; f < faceCount; ++f)
+        {
+            if (taken[f] != 1) continue;
+
+            const ATTR& attr = *(const ATTR*)&mesh.Attributes[f];
+            int32_t minV[3], maxV[3];
+            Bounds(mesh, f, minV, maxV);
+            int32_t width = Length(maxV[0] - minV[0], maxV[2] - minV[2]);
+
+            // Parceira: mesma textura e centro XZ dentro de meia largura (arvore em X)
+            size_t partner = faceCount;
+            for (size_t g = f + 1; g < faceCount && partner == faceCount; ++g)
+            {
+                if (taken[g] != 1 || ((const ATTR*)&mesh.Attributes[g])->texno != attr.texno) continue;
+
+                int32_t otherMin[3], otherMax[3];
+                Bounds(mesh, g, otherMin, otherMax);
+                int32_t dx = (otherMin[0] + otherMax[0]) / 2 - (minV[0] + maxV[0]) / 2;
+                int32_t dz = (otherMin[2] + otherMax[2]) / 2 - (minV[2] + maxV[2]) / 2;
+                if (Abs(dx) + Abs(dz) > width / 2) continue;
+
+                partner = g;
+                int32_t otherWidth = Length(otherMax[0] - otherMin[0], otherMax[2] - otherMin[2]);
+                if (otherWidth > width) width = otherWidth;
+                for (size_t k = 0; k < 3; ++k)
+                {
+                    if (otherMin[k] < minV[k]) minV[k] = otherMin[k];
+                    if (otherMax[k] > maxV[k]) maxV[k] = otherMax[k];
+                }
+            }
+
+            Sprite sprite = {};
+            sprite.texture = attr.texno;
+            sprite.flip = attr.dir & (FlipH | FlipV);
+            if (partner != faceCount)
+            {
+                taken[partner] = 2;
+                int32_t height = maxV[1] - minV[1];
+                int32_t centerX = minV[0] + (maxV[0] - minV[0]) / 2;
+                int32_t centerZ = minV[2] + (maxV[2] - minV[2]) / 2;
+                sprite.kind = Kind::Facing;
+                sprite.point[0][0] = sprite.point[1][0] = centerX;
+                sprite.point[0][2] = sprite.point[1][2] = centerZ;
+                sprite.point[0][1] = minV[1]; // Y+ do arquivo para cima
+                sprite.point[1][1] = maxV[1];
+                sprite.aspect = height > 0 ? (int32_t)(((int64_t)width << 16) / height) : 0x10000;
+            }
+            else
+            {
+                sprite.kind = Kind::Fixed;
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    const auto& p = mesh.Vertices[mesh.Faces[f].Vertices[i]];
+                    sprite.point[i][0] = p.X.RawValue();
+                    sprite.point[i][1] = p.Y.RawValue();
+                    sprite.point[i][2] = p.Z.RawValue();
+                }
+            }
+            sprites.push_back(sprite);
+            count[meshId]++;
+        }
+
+        // Compacta o que sobrou; indices de gouraud das faces ficam como estavam
+        size_t kept = 0;
+        for (size_t f = 0; f < faceCount; ++f)
+        {
+            if (taken[f] != 0) continue;
+            mesh.Faces[kept] = mesh.Faces[f];
+            mesh.Attributes[kept] = mesh.Attributes[f];
+            ++kept;
+        }
+        mesh.FaceCount = kept;
+        return count[meshId];
+    }
+
+    static SRL::Math::Types::Fxp Project(const int32_t* point, SRL::Math::Types::Vector2D& screen)
+    {
+        using SRL::Math::Types::Fxp;
+        return SRL::Scene3D::ProjectToScreen(SRL::Math::Types::Vector3D(Fxp::BuildRaw(point[0]), Fxp::BuildRaw(point[1]), Fxp::BuildRaw(point[2])), &screen);
+    }
+
+    // Cantos na ordem A-B-C-D da textura (como os vertices do POLYGON)
+    static void Flip(SRL::Math::Types::Vector3D* corners, uint8_t flip)
+    {
+        if (flip & FlipH)
+        {
+            SRL::Math::Types::Vector3D a = corners[0], d = corners[3];
+            corners[0] = corners[1];
+            corners[1] = a;
+            corners[3] = corners[2];
+            corners[2] = d;
+        }
+        if (flip & FlipV)
+        {
+            SRL::Math::Types::Vector3D a = corners[0], b = corners[1];
+            corners[0] = corners[3];
+            corners[3] = a;
+            corners[1] = corners[2];
+            corners[2] = b;
+        }
+    }
+
+    bool ProjectFacing(const Sprite& sprite, SRL::Math::Types::Vector3D* corners) const
+    {
+        using SRL::Math::Types::Fxp;
+        SRL::Math::Types::Vector2D base, top;
+        Fxp depth = Project(sprite.point[0], base);
+        if (depth.RawValue() < NearDepth || Project(sprite.point[1], top).RawValue() < NearDepth) return false;
+
+        // Meia largura na tela pela altura projetada: o sprite fica em pe e de frente
+        int32_t half = (int32_t)(((int64_t)Abs(base.Y.RawValue() - top.Y.RawValue()) * sprite.aspect) >> (tallPixels ? 18 : 17));
+        corners[0] = SRL::Math::Types::Vector3D(Fxp::BuildRaw(top.X.RawValue() - half), top.Y, depth);
+        corners[1] = SRL::Math::Types::Vector3D(Fxp::BuildRaw(top.X.RawValue() + half), top.Y, depth);
+        corners[2] = SRL::Math::Types::Vector3D(Fxp::BuildRaw(base.X.RawValue() + half), base.Y, depth);
+        corners[3] = SRL::Math::Types::Vector3D(Fxp::BuildRaw(base.X.RawValue() - half), base.Y, depth);
+        return true;
+    }
+
+    bool ProjectFixed(const Sprite& sprite, SRL::Math::Types::Vector3D* corners) const
+    {
+        using SRL::Math::Types::Fxp;
+        SRL::Math::Types::Vector2D screen[4];
+        int32_t depthSum = 0;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            int32_t depth = Project(sprite.point[i], screen[i]).RawValue();
+            if (depth < NearDepth) return false;
+            depthSum += depth >> 2;
+        }
+
+        for (size_t i = 0; i < 4; ++i) corners[i] = SRL::Math::Types::Vector3D(screen[i].X, screen[i].Y, Fxp::BuildRaw(depthSum));
+        return true;
+    }
+
+    void BeginFrame()
+    {
+        drawn = 0;
+    }
+
+    /** @brief Desenha os sprites de uma malha da pista
+     * @note Com a matriz da pista no topo da pilha (mesmo espaco das faces)
+     */
+    WORKRAM_HOT void Draw(uint16_t meshId)
+    {
+        if (meshId >= MaxMeshes) return;
+
+        for (uint16_t i = first[meshId]; i < first[meshId] + count[meshId]; ++i)
+        {
+            const Sprite& sprite = sprites[i];
+            SRL::Math::Types::Vector3D corners[4];
+            bool visible = sprite.kind == Kind::Facing ? ProjectFacing(sprite, corners) : ProjectFixed(sprite, corners);
+            if (!visible) continue;
+
+            Flip(corners, sprite.flip);
+            SRL::Scene2D::DrawSprite(sprite.texture, corners);
+            ++drawn;
+        }
+    }
+};
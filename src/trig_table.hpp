@@ -0,0 +1,56 @@
+#pragma once
+
+#include <srl.hpp>
+#include <array>
+
+// Seno/cosseno por grau inteiro em 16.16, gerados em tempo de compilacao.
+// Os angulos da camera sao inteiros em graus, entao a tabela cobre todos os casos sem trigonometria no frame.
+namespace TrigTable
+{
+    constexpr double Pi = 3.14159265358979323846;
+
+    // Serie de Taylor em [-pi, pi]: so roda no compilador
+    constexpr double Sine(double x)
+    {
+        while (x > Pi) x -= 2.0 * Pi;
+        while (x < -Pi) x += 2.0 * Pi;
+
+        double term = x;
+        double sum = x;
+        for (int n = 1; n < 12; ++n)
+        {
+            term *= -x * x / ((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr std::array<int32_t, 360> BuildSines()
+    {
+        std::array<int32_t, 360> table{};
+        for (int deg = 0; deg < 360; ++deg)
+        {
+            double value = Sine(deg * Pi / 180.0) * 65536.0;
+            table[deg] = (int32_t)(value < 0 ? value - 0.5 : value + 0.5);
+        }
+        return table;
+    }
+
+    inline constexpr std::array<int32_t, 360> Sines = BuildSines();
+
+    constexpr int32_t Wrap(int32_t deg)
+    {
+        deg %= 360;
+        return deg < 0 ? deg + 360 : deg;
+    }
+
+    inline SRL::Math::Types::Fxp Sin(int32_t deg)
+    {
+        return SRL::Math::Types::Fxp::BuildRaw(Sines[Wrap(deg)]);
+    }
+
+    inline SRL::Math::Types::Fxp Cos(int32_t deg)
+    {
+        return SRL::Math::Types::Fxp::BuildRaw(Sines[Wrap(deg + 90)]);
+    }
+} // namespace TrigTable
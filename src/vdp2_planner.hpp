@@ -0,0 +1,182 @@
+#pragma once
+
+#include <srl.hpp>
+
+// Planejador de VRAM do VDP2: registra quem ocupa cada banco (A0/A1/B0/B1) e com que uso,
+// e acusa conflitos no load (banco do RBG0 dividido, ciclos de acesso estourados, falta de VRAM).
+// O RBG0 le um banco inteiro com um tipo so (coeficiente, nome de padrao ou celula): um banco dele
+// nao divide espaco com camadas NBG nem com outro tipo de dado do proprio RBG0.
+// Layout de boot com chao, troca de ceu e HUD (0 conflitos):
+//   A0: regiao 1 do SkySwitcher (mapa + 1152 celulas), tabela de line scroll, HUD    5 ciclos
+//   A1: bitmap do chao (RBG0)                                                         2 ciclos
+//   B0: coeficientes do chao (RBG0)                                                   8 ciclos
+//   B1: regiao 0 do SkySwitcher (mapa + 1920 celulas)                                 3 ciclos
+namespace Vdp2Planner
+{
+    enum class Usage : uint8_t
+    {
+        Character,   // celulas de tilemap (NBG/RBG)
+        PatternName, // mapa de nomes de padrao
+        Bitmap,      // bitmap direto
+        Coefficient, // tabela de coeficientes do RBG0
+        LineScroll,  // tabela de line scroll (lida no hblank, sem ciclo)
+    };
+
+    enum class Layer : uint8_t
+    {
+        Normal,   // NBG0-3, HUD, tabelas
+        Rotation, // RBG0 (coeficientes sempre)
+    };
+
+    struct Region
+    {
+        const char* owner;
+        Usage usage;
+        Layer layer;
+        uint8_t bank;
+        uint8_t cycles;  // slots de acesso por linha usados neste banco
+        uint32_t size;
+        void* address;   // nullptr quando o SRL alocou internamente
+    };
+
+    constexpr size_t BankCount = 4;
+    constexpr size_t MaxRegions = 16;
+    constexpr uint8_t CyclesPerBank = 8; // T0..T7 em low-res
+    constexpr const char* BankNames[BankCount] = {"A0", "A1", "B0", "B1"};
+
+    inline Region regions[MaxRegions];
+    inline size_t regionCount = 0;
+    inline uint8_t cyclesUsed[BankCount] = {};
+    inline size_t conflictCount = 0;
+
+    // Ultimo conflito, para o HUD (HudStats)
+    inline const char* lastOwner = nullptr;
+    inline const char* lastReason = nullptr;
+    inline uint8_t lastBank = 0;
+
+    // Slots por linha que uma camada precisa para buscar dados do banco
+    inline uint8_t CyclesFor(Usage usage, SRL::CRAM::TextureColorMode mode = SRL::CRAM::TextureColorMode::Paletted256)
+    {
+        switch (usage)
+        {
+        case Usage::PatternName: return 1;
+        case Usage::Character:
+        case Usage::Bitmap: return mode == SRL::CRAM::TextureColorMode::Paletted16 ? 1 : (mode == SRL::CRAM::TextureColorMode::Paletted256 ? 2 : 4);
+        case Usage::Coefficient: return CyclesPerBank; // RBG0 le coeficientes em todos os slots do banco
+        default: return 0;
+        }
+    }
+
+    inline void Conflict(const char* owner, const char* reason, size_t bank)
+    {
+        lastOwner = owner;
+        lastReason = reason;
+        lastBank = (uint8_t)bank;
+        conflictCount++;
+    }
+
+    inline bool IsRotation(const Region& region)
+    {
+        return region.layer == Layer::Rotation || region.usage == Usage::Coefficient;
+    }
+
+    // Aplica as regras do banco para uma nova regiao (todas; cada uma acusa no maximo uma vez)
+    inline void Check(const Region& region)
+    {
+        for (size_t i = 0; i < regionCount; ++i)
+        {
+            const Region& other = regions[i];
+            if (other.bank != region.bank) continue;
+            if (!IsRotation(region) && !IsRotation(other)) continue;
+
+            if (IsRotation(region) != IsRotation(other))
+            {
+                Conflict(region.owner, "banco RBG0 com NBG", region.bank);
+                break;
+            }
+            if (region.usage != other.usage)
+            {
+                Conflict(region.owner, "banco RBG0 com 2 tipos", region.bank);
+                break;
+            }
+        }
+
+        if (cyclesUsed[region.bank] + region.cycles > CyclesPerBank)
+        {
+            Conflict(region.owner, "ciclos esgotados", region.bank);
+        }
+    }
+
+    inline void Record(const char* owner, Usage usage, size_t bank, uint32_t size, uint8_t cycles, void* address, Layer layer = Layer::Normal)
+    {
+        if (regionCount >= MaxRegions || bank >= BankCount) return;
+
+        Region region{owner, usage, layer, (uint8_t)bank, cycles, size, address};
+        Check(region);
+        cyclesUsed[bank] += cycles;
+        regions[regionCount++] = region;
+    }
+
+    /** @brief Aloca uma regiao num banco especifico e registra seu uso
+     * @return Endereco em VRAM ou nullptr (conflito registrado)
+     */
+    inline void* Allocate(const char* owner, Usage usage, uint32_t size, uint32_t boundary, SRL::VDP2::VramBank bank, uint8_t cycles,
+                          Layer layer = Layer::Normal)
+    {
+        void* address = SRL::VDP2::VRAM::Allocate(size, boundary, bank, 0);
+        if (address == nullptr)
+        {
+            Conflict(owner, "sem VRAM", (size_t)bank);
+            return nullptr;
+        }
+
+        Record(owner, usage, (size_t)bank, size, cycles, address, layer);
+        return address;
+    }
+
+    // Memoria livre por banco antes de uma carga feita pelo SRL (LoadTilemap)
+    struct Snapshot
+    {
+        size_t available[BankCount];
+    };
+
+    inline Snapshot TakeSnapshot()
+    {
+        Snapshot snap;
+        for (size_t bank = 0; bank < BankCount; ++bank)
+        {
+            snap.available[bank] = SRL::VDP2::VRAM::GetAvailable((SRL::VDP2::VramBank)bank);
+        }
+        return snap;
+    }
+
+    /** @brief Registra um tilemap que o SRL carregou desde o snapshot (bancos cuja memoria livre caiu)
+     * @note O banco que mais perdeu fica com as celulas, os outros com o mapa: cada um paga so os seus ciclos
+     */
+    inline void RecordSince(const Snapshot& before, const char* owner, Layer layer, uint8_t characterCycles, uint8_t patternCycles)
+    {
+        size_t used[BankCount] = {};
+        size_t cellBank = BankCount;
+        for (size_t bank = 0; bank < BankCount; ++bank)
+        {
+            size_t now = SRL::VDP2::VRAM::GetAvailable((SRL::VDP2::VramBank)bank);
+            if (now >= before.available[bank]) continue;
+
+            used[bank] = before.available[bank] - now;
+            if (cellBank == BankCount || used[bank] > used[cellBank]) cellBank = bank;
+        }
+
+        for (size_t bank = 0; bank < BankCount; ++bank)
+        {
+            if (used[bank] == 0) continue;
+            if (bank == cellBank) Record(owner, Usage::Character, bank, (uint32_t)used[bank], characterCycles, nullptr, layer);
+            else Record(owner, Usage::PatternName, bank, (uint32_t)used[bank], patternCycles, nullptr, layer);
+        }
+    }
+
+    // Ciclos livres por banco (para o HUD)
+    inline int32_t FreeCycles(size_t bank)
+    {
+        return bank < BankCount ? (int32_t)CyclesPerBank - (int32_t)cyclesUsed[bank] : 0;
+    }
+} // namespace Vdp2Planner
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <srl.hpp>
+
+// Resolucao trocada em tempo de execucao: 320x224 progressivo ou 320x448 entrelacado (double interlace).
+// No entrelacado cada campo da VDP1 desenha so as linhas pares ou impares no framebuffer de 224 linhas,
+// entao o custo de desenho por frame fica o do modo baixo e a imagem dobra a definicao vertical.
+// 640/704 de largura nao entram: a VDP1 cairia para framebuffer de 8 bpp e perderia gouraud e RGB.
+// Quem depende da altura da tela le 'doubled' e 'height' depois da troca.
+struct VideoMode
+{
+    enum class Mode : uint8_t
+    {
+        Low,        // 320x224
+        Interlaced, // 320x448i
+    };
+
+    static constexpr uint16_t Width = 320;
+    static constexpr uint16_t LowHeight = 224;
+
+    Mode mode = Mode::Low;
+    uint16_t height = LowHeight;
+    bool doubled = false;
+
+    /** @brief Troca o modo da VDP2 e da VDP1 e a janela de projecao do SGL
+     * @note Chamar entre frames (depois do Synchronize); o quadro seguinte ja sai no modo novo
+     * @return true se o modo mudou
+     */
+    bool Set(Mode next)
+    {
+        if (next == mode) return false;
+        mode = next;
+        doubled = next == Mode::Interlaced;
+        height = doubled ? LowHeight * 2 : LowHeight;
+
+        slSetScrTVMode(doubled ? TV_320x448 : TV_320x224);
+        slSetSprTVMode(doubled ? TV_320x448 : TV_320x224);
+
+        // Centro da projecao no meio da tela nova; a escala vertical fica com Apply
+        slWindow(0, 0, Width - 1, height - 1, 0x7fff, Width / 2, height / 2);
+        return true;
+    }
+
+    bool Toggle()
+    {
+        return Set(doubled ? Mode::Low : Mode::Interlaced);
+    }
+
+    /** @brief Pixels do entrelacado tem meia altura: Y da camera dobra para manter a proporcao
+     * @note Logo depois do LoadIdentity, antes do LookAt (escala no espaco da camera)
+     */
+    void Apply() const
+    {
+        if (doubled) slScale(toFIXED(1.0), toFIXED(2.0), toFIXED(1.0));
+    }
+};
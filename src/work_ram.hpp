@@ -0,0 +1,100 @@
+#pragma once
+
+#include <srl.hpp>
+
+// Plano da memoria de trabalho. O SDK liga codigo, dados e o heap padrao (new) na HWRAM (1 MB, rapida):
+// ali fica o que e lido todo frame (malhas, listas de culling/ordenacao, tabelas de gouraud, colisao).
+// A LWRAM (1 MB, acesso mais lento) recebe o que so passa por ela: arquivos lidos do CD, staging de
+// upload para VDP1/VDP2 e janelas de conversao.
+namespace WorkRam
+{
+    enum class Region : uint8_t
+    {
+        High, // 0x06000000, quente
+        Low,  // 0x00200000, streaming e staging
+    };
+
+    struct Block
+    {
+        const char* owner;
+        void* address;
+        uint32_t size;
+        Region region;
+    };
+
+    constexpr size_t RegionCount = 2;
+    constexpr size_t MaxBlocks = 32;
+    constexpr const char* RegionNames[RegionCount] = {"HWRAM", "LWRAM"};
+
+    inline Block blocks[MaxBlocks];
+    inline size_t blockCount = 0;
+    inline uint32_t used[RegionCount] = {};
+    inline uint32_t peak[RegionCount] = {};
+    inline size_t fallbackCount = 0; // pedidos de LWRAM atendidos pela HWRAM
+
+    inline void Record(const char* owner, void* address, uint32_t size, Region region)
+    {
+        size_t index = (size_t)region;
+        used[index] += size;
+        if (used[index] > peak[index]) peak[index] = used[index];
+        if (blockCount < MaxBlocks) blocks[blockCount++] = Block{owner, address, size, region};
+    }
+
+    /** @brief Aloca numa regiao e registra o dono (relatorio de boot)
+     * @note Sem espaco na LWRAM cai para a HWRAM e conta em fallbackCount
+     * @return Endereco ou nullptr
+     */
+    inline void* Allocate(const char* owner, Region region, uint32_t size)
+    {
+        void* address = nullptr;
+        if (region == Region::Low)
+        {
+            address = SRL::Memory::LowWorkRam::Malloc(size);
+            if (address == nullptr)
+            {
+                fallbackCount++;
+                region = Region::High;
+            }
+        }
+
+        if (address == nullptr) address = SRL::Memory::HighWorkRam::Malloc(size);
+        if (address != nullptr) Record(owner, address, size, region);
+        return address;
+    }
+
+    inline void Free(void* address)
+    {
+        if (address == nullptr) return;
+
+        for (size_t i = 0; i < blockCount; ++i)
+        {
+            if (blocks[i].address != address) continue;
+            used[(size_t)blocks[i].region] -= blocks[i].size;
+            blocks[i] = blocks[--blockCount];
+            break;
+        }
+        SRL::Memory::Free(address);
+    }
+
+    inline uint32_t FreeBytes(Region region)
+    {
+        return region == Region::Low ? SRL::Memory::LowWorkRam::GetFreeSpace() : SRL::Memory::HighWorkRam::GetFreeSpace();
+    }
+
+    // Maior bloco ainda vivo de uma regiao (para o relatorio)
+    inline const Block* Largest(Region region)
+    {
+        const Block* largest = nullptr;
+        for (size_t i = 0; i < blockCount; ++i)
+        {
+            if (blocks[i].region == region && (largest == nullptr || blocks[i].size > largest->size)) largest = &blocks[i];
+        }
+        return largest;
+    }
+} // namespace WorkRam
+
+// Funcoes do laco de frame: o GCC as junta em .text.hot, contiguas na HWRAM e com menos conflito no cache
+#define WORKRAM_HOT __attribute__((hot))
+
+// Codigo so de load: vai para .text.unlikely, longe do caminho quente
+#define WORKRAM_COLD __attribute__((cold))
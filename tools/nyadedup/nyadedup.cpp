@@ -0,0 +1,217 @@
+// Remove texturas repetidas de um modelo .NYA e remapeia as faces
+//
+// Uso: nyadedup entrada.nya saida.nya [entrada2.nya saida2.nya ...]
+// Compilar: g++ -std=c++17 -O2 -o nyadedup nyadedup.cpp
+//
+// Imagens iguais (mesmo tamanho e pixels) ficam uma vez so no arquivo; Attribute.Texture das faces
+// passa a apontar para a copia mantida. Com varios modelos o relatorio mostra tambem as imagens
+// repetidas entre arquivos, que o TextureCache ja compartilha em tempo de execucao.
+//
+// Formato (big-endian, lido por ModelObject):
+//   u32 type (0 = PDATA, 1 = XPDATA), u32 meshCount, u32 textureCount
+//   por malha: u32 pointCount, u32 polygonCount, pontos (12 bytes), poligonos (20 bytes),
+//              atributos (8 bytes: flags, u16 cor, i32 textura), normais por vertice se type 1 (12 bytes)
+//   por textura: u16 width, u16 height, u16 pixels[width * height]
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr size_t HeaderBytes = 12;
+    constexpr size_t PointBytes = 12;
+    constexpr size_t PolygonBytes = 20;
+    constexpr size_t AttributeBytes = 8;
+    constexpr uint8_t HasTexture = 0x80; // primeiro campo de bits = bit mais alto no SH-2
+
+    struct Model
+    {
+        std::string path;
+        std::vector<uint8_t> data;
+        uint32_t type = 0;
+        std::vector<size_t> attributeOffsets;
+        std::vector<size_t> textureOffsets;
+        std::vector<size_t> textureSizes;
+    };
+
+    bool ReadFile(const char* path, std::vector<uint8_t>& out)
+    {
+        FILE* f = std::fopen(path, "rb");
+        if (f == nullptr) return false;
+        std::fseek(f, 0, SEEK_END);
+        long size = std::ftell(f);
+        std::fseek(f, 0, SEEK_SET);
+        out.resize(size > 0 ? (size_t)size : 0);
+        bool ok = size > 0 && std::fread(out.data(), 1, out.size(), f) == out.size();
+        std::fclose(f);
+        return ok;
+    }
+
+    bool WriteFile(const char* path, const std::vector<uint8_t>& data)
+    {
+        FILE* f = std::fopen(path, "wb");
+        if (f == nullptr) return false;
+        bool ok = std::fwrite(data.data(), 1, data.size(), f) == data.size();
+        std::fclose(f);
+        return ok;
+    }
+
+    uint32_t Read32(const std::vector<uint8_t>& data, size_t offset)
+    {
+        return ((uint32_t)data[offset] << 24) | ((uint32_t)data[offset + 1] << 16) | ((uint32_t)data[offset + 2] << 8) | data[offset + 3];
+    }
+
+    uint16_t Read16(const std::vector<uint8_t>& data, size_t offset)
+    {
+        return (uint16_t)((data[offset] << 8) | data[offset + 1]);
+    }
+
+    void Write32(std::vector<uint8_t>& data, size_t offset, uint32_t value)
+    {
+        data[offset] = (uint8_t)(value >> 24);
+        data[offset + 1] = (uint8_t)(value >> 16);
+        data[offset + 2] = (uint8_t)(value >> 8);
+        data[offset + 3] = (uint8_t)value;
+    }
+
+    bool Parse(Model& model, std::string& error)
+    {
+        const std::vector<uint8_t>& data = model.data;
+        if (data.size() < HeaderBytes) { error = "arquivo curto"; return false; }
+
+        model.type = Read32(data, 0);
+        uint32_t meshCount = Read32(data, 4);
+        uint32_t textureCount = Read32(data, 8);
+        size_t offset = HeaderBytes;
+
+        for (uint32_t mesh = 0; mesh < meshCount; ++mesh)
+        {
+            if (offset + 8 > data.size()) { error = "malha truncada"; return false; }
+            uint32_t points = Read32(data, offset);
+            uint32_t polygons = Read32(data, offset + 4);
+            offset += 8 + points * PointBytes + polygons * PolygonBytes;
+
+            for (uint32_t i = 0; i < polygons; ++i)
+            {
+                model.attributeOffsets.push_back(offset);
+                offset += AttributeBytes;
+            }
+
+            if (model.type == 1) offset += points * PointBytes;
+        }
+
+        for (uint32_t texture = 0; texture < textureCount; ++texture)
+        {
+            if (offset + 4 > data.size()) { error = "textura truncada"; return false; }
+            size_t size = 4 + (size_t)Read16(data, offset) * Read16(data, offset + 2) * 2;
+            model.textureOffsets.push_back(offset);
+            model.textureSizes.push_back(size);
+            offset += size;
+        }
+
+        if (offset != data.size()) { error = "sobra no fim do arquivo"; return false; }
+        return true;
+    }
+
+    std::string Key(const Model& model, size_t texture)
+    {
+        const uint8_t* begin = model.data.data() + model.textureOffsets[texture];
+        return std::string(begin, begin + model.textureSizes[texture]);
+    }
+
+    // Mantem a primeira copia de cada imagem e devolve o arquivo reescrito
+    std::vector<uint8_t> Dedup(Model& model, size_t& removed)
+    {
+        std::map<std::string, uint32_t> unique;
+        std::vector<uint32_t> remap(model.textureOffsets.size());
+        std::vector<size_t> kept;
+
+        for (size_t texture = 0; texture < model.textureOffsets.size(); ++texture)
+        {
+            auto found = unique.emplace(Key(model, texture), (uint32_t)kept.size());
+            if (found.second) kept.push_back(texture);
+            remap[texture] = found.first->second;
+        }
+        removed = model.textureOffsets.size() - kept.size();
+
+        size_t textureStart = model.textureOffsets.empty() ? model.data.size() : model.textureOffsets[0];
+        std::vector<uint8_t> out(model.data.begin(), model.data.begin() + textureStart);
+        Write32(out, 8, (uint32_t)kept.size());
+
+        for (size_t offset : model.attributeOffsets)
+        {
+            if ((out[offset] & HasTexture) == 0) continue;
+            uint32_t texture = Read32(out, offset + 4);
+            if (texture < remap.size()) Write32(out, offset + 4, remap[texture]);
+        }
+
+        for (size_t texture : kept)
+        {
+            const uint8_t* begin = model.data.data() + model.textureOffsets[texture];
+            out.insert(out.end(), begin, begin + model.textureSizes[texture]);
+        }
+        return out;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3 || (argc - 1) % 2 != 0)
+    {
+        std::fprintf(stderr, "uso: %s entrada.nya saida.nya [entrada2.nya saida2.nya ...]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<Model> models;
+    for (int i = 1; i < argc; i += 2)
+    {
+        Model model;
+        model.path = argv[i];
+        std::string error;
+        if (!ReadFile(argv[i], model.data))
+        {
+            std::fprintf(stderr, "%s: nao foi possivel ler\n", argv[i]);
+            return 1;
+        }
+        if (!Parse(model, error))
+        {
+            std::fprintf(stderr, "%s: %s\n", argv[i], error.c_str());
+            return 1;
+        }
+        models.push_back(std::move(model));
+    }
+
+    // Repetidas entre modelos: ficam nos dois arquivos, o TextureCache divide o slot na VDP1
+    std::map<std::string, std::string> owners;
+    size_t shared = 0;
+    for (const Model& model : models)
+    {
+        for (size_t texture = 0; texture < model.textureOffsets.size(); ++texture)
+        {
+            auto found = owners.emplace(Key(model, texture), model.path);
+            if (!found.second && found.first->second != model.path) shared++;
+        }
+    }
+
+    for (size_t i = 0; i < models.size(); ++i)
+    {
+        Model& model = models[i];
+        size_t removed = 0;
+        std::vector<uint8_t> out = Dedup(model, removed);
+        const char* outPath = argv[2 + i * 2];
+        if (!WriteFile(outPath, out))
+        {
+            std::fprintf(stderr, "%s: nao foi possivel gravar\n", outPath);
+            return 1;
+        }
+
+        std::printf("%s: %zu texturas, %zu repetidas removidas, %zu -> %zu bytes\n",
+                    model.path.c_str(), model.textureOffsets.size(), removed, model.data.size(), out.size());
+    }
+
+    if (models.size() > 1) std::printf("texturas repetidas entre modelos: %zu\n", shared);
+    return 0;
+}
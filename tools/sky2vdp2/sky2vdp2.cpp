@@ -0,0 +1,223 @@
+// Conversor offline TGA -> ceu no formato nativo do VDP2 (.SKY)
+//
+// Uso: sky2vdp2 entrada.tga saida.sky
+// Compilar: g++ -std=c++17 -O2 -o sky2vdp2 sky2vdp2.cpp
+//
+// Entrada: TGA 8bpp paletizado (tipo 1 ou 9/RLE), largura/altura multiplas de 8, ate 512x512.
+// Saida (big-endian, lida por SkySwitcher::LoadNow):
+//   char  magic[4]        "SKY1"
+//   u16   width, height   em pixels
+//   u16   cellCount       celulas 8x8 unicas
+//   u16   reserved        0
+//   u16   palette[256]    RGB555 com bit 15 ligado
+//   u16   map[64*64]      nome de padrao (1 word, numero de celula * 2), pagina 64x64 ja repetida
+//   u8    cells[cellCount * 64]  celulas 8x8 @ 8bpp, sem repeticao
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int MapSize = 64;
+    constexpr int CellBytes = 64;
+    constexpr int MaxCells = 2048; // 128 KB = um banco inteiro (regiao do SkySwitcher)
+
+    struct Image
+    {
+        int width = 0;
+        int height = 0;
+        uint16_t palette[256] = {};
+        std::vector<uint8_t> pixels; // linha 0 = topo
+    };
+
+    bool ReadFile(const char* path, std::vector<uint8_t>& out)
+    {
+        FILE* f = std::fopen(path, "rb");
+        if (f == nullptr) return false;
+        std::fseek(f, 0, SEEK_END);
+        long size = std::ftell(f);
+        std::fseek(f, 0, SEEK_SET);
+        out.resize(size > 0 ? (size_t)size : 0);
+        bool ok = size > 0 && std::fread(out.data(), 1, out.size(), f) == out.size();
+        std::fclose(f);
+        return ok;
+    }
+
+    bool DecodeTga(const std::vector<uint8_t>& data, Image& image, std::string& error)
+    {
+        if (data.size() < 18) { error = "arquivo curto"; return false; }
+
+        const uint8_t idLength = data[0];
+        const uint8_t colorMapType = data[1];
+        const uint8_t imageType = data[2];
+        const int colorMapFirst = data[3] | (data[4] << 8);
+        const int colorMapLength = data[5] | (data[6] << 8);
+        const int entryBytes = data[7] / 8;
+        image.width = data[12] | (data[13] << 8);
+        image.height = data[14] | (data[15] << 8);
+        const int bpp = data[16];
+        const bool topDown = (data[17] & 0x20) != 0;
+
+        if (colorMapType != 1 || (imageType != 1 && imageType != 9) || bpp != 8)
+        {
+            error = "esperado TGA 8bpp paletizado (tipo 1 ou 9)";
+            return false;
+        }
+
+        if ((image.width % 8) != 0 || (image.height % 8) != 0 || image.width > MapSize * 8 || image.height > MapSize * 8)
+        {
+            error = "dimensoes devem ser multiplas de 8 e no maximo 512x512";
+            return false;
+        }
+
+        size_t pos = 18 + idLength;
+        if (pos + (size_t)colorMapLength * entryBytes > data.size()) { error = "paleta truncada"; return false; }
+        for (int i = 0; i < colorMapLength && colorMapFirst + i < 256; ++i)
+        {
+            const uint8_t* c = &data[pos + (size_t)i * entryBytes];
+            image.palette[colorMapFirst + i] = (uint16_t)(0x8000 | (c[2] >> 3) | ((c[1] >> 3) << 5) | ((c[0] >> 3) << 10));
+        }
+        pos += (size_t)colorMapLength * entryBytes;
+
+        const size_t total = (size_t)image.width * image.height;
+        std::vector<uint8_t> raw;
+        raw.reserve(total);
+        while (raw.size() < total)
+        {
+            if (pos >= data.size()) { error = "dados de imagem truncados"; return false; }
+            if (imageType == 1)
+            {
+                raw.push_back(data[pos++]);
+                continue;
+            }
+
+            const uint8_t header = data[pos++];
+            const int count = (header & 0x7f) + 1;
+            if (header & 0x80)
+            {
+                if (pos >= data.size()) { error = "RLE truncado"; return false; }
+                raw.insert(raw.end(), count, data[pos++]);
+            }
+            else
+            {
+                if (pos + count > data.size()) { error = "RLE truncado"; return false; }
+                raw.insert(raw.end(), data.begin() + pos, data.begin() + pos + count);
+                pos += count;
+            }
+        }
+        raw.resize(total);
+
+        image.pixels.resize(total);
+        for (int y = 0; y < image.height; ++y)
+        {
+            const int srcRow = topDown ? y : (image.height - 1 - y);
+            std::memcpy(&image.pixels[(size_t)y * image.width], &raw[(size_t)srcRow * image.width], image.width);
+        }
+        return true;
+    }
+
+    void PutU16(std::vector<uint8_t>& out, uint16_t v)
+    {
+        out.push_back((uint8_t)(v >> 8));
+        out.push_back((uint8_t)(v & 0xff));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::fprintf(stderr, "uso: %s entrada.tga saida.sky\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<uint8_t> tga;
+    if (!ReadFile(argv[1], tga))
+    {
+        std::fprintf(stderr, "%s: nao foi possivel ler\n", argv[1]);
+        return 1;
+    }
+
+    Image image;
+    std::string error;
+    if (!DecodeTga(tga, image, error))
+    {
+        std::fprintf(stderr, "%s: %s\n", argv[1], error.c_str());
+        return 1;
+    }
+
+    // Fatia em celulas 8x8 e guarda cada celula distinta uma unica vez
+    const int cellsX = image.width / 8;
+    const int cellsY = image.height / 8;
+    std::vector<uint8_t> cells;
+    std::map<std::string, uint16_t> unique;
+    std::vector<uint16_t> cellMap((size_t)cellsX * cellsY);
+
+    for (int cy = 0; cy < cellsY; ++cy)
+    {
+        for (int cx = 0; cx < cellsX; ++cx)
+        {
+            std::string cell(CellBytes, '\0');
+            for (int line = 0; line < 8; ++line)
+            {
+                std::memcpy(&cell[line * 8], &image.pixels[(size_t)(cy * 8 + line) * image.width + cx * 8], 8);
+            }
+
+            auto found = unique.find(cell);
+            uint16_t index;
+            if (found != unique.end())
+            {
+                index = found->second;
+            }
+            else
+            {
+                if (unique.size() >= (size_t)MaxCells)
+                {
+                    std::fprintf(stderr, "%s: mais de %d celulas unicas\n", argv[1], MaxCells);
+                    return 1;
+                }
+                index = (uint16_t)unique.size();
+                unique.emplace(cell, index);
+                cells.insert(cells.end(), cell.begin(), cell.end());
+            }
+            cellMap[(size_t)cy * cellsX + cx] = index;
+        }
+    }
+
+    std::vector<uint8_t> out;
+    out.insert(out.end(), {'S', 'K', 'Y', '1'});
+    PutU16(out, (uint16_t)image.width);
+    PutU16(out, (uint16_t)image.height);
+    PutU16(out, (uint16_t)unique.size());
+    PutU16(out, 0);
+    for (uint16_t color : image.palette) PutU16(out, color);
+
+    // Pagina 64x64 repetindo a imagem (mesmo periodo do scroll do NBG0)
+    for (int y = 0; y < MapSize; ++y)
+    {
+        for (int x = 0; x < MapSize; ++x)
+        {
+            uint16_t index = cellMap[(size_t)(y % cellsY) * cellsX + (x % cellsX)];
+            PutU16(out, (uint16_t)((index * 2) & 0x0fff));
+        }
+    }
+
+    out.insert(out.end(), cells.begin(), cells.end());
+
+    FILE* f = std::fopen(argv[2], "wb");
+    if (f == nullptr || std::fwrite(out.data(), 1, out.size(), f) != out.size())
+    {
+        std::fprintf(stderr, "%s: nao foi possivel gravar\n", argv[2]);
+        if (f != nullptr) std::fclose(f);
+        return 1;
+    }
+    std::fclose(f);
+
+    std::printf("%s: %dx%d, %zu/%d celulas unicas, %zu bytes\n", argv[2], image.width, image.height,
+                unique.size(), cellsX * cellsY, out.size());
+    return 0;
+}
@@ -0,0 +1,278 @@
+// Gera as tabelas de gouraud dos presets de luz (LightingPresets) a partir das imagens de ceu
+//
+// Uso: skylight saida.hpp nome=fonte[@brilho] [nome=fonte[@brilho] ...]
+//   fonte: ceu.tga (TGA 8bpp paletizado, tipo 1 ou 9/RLE) ou cor fixa #rrggbb (ceu e horizonte iguais)
+//   brilho: porcentagem da rampa (100 = padrao)
+// Compilar: g++ -std=c++17 -O2 -o skylight skylight.cpp
+//
+// A tabela tem 32 entradas indexadas pela intensidade da luz no vertice (16 = texel sem alteracao).
+// O terco de cima da imagem da a cor do ceu e o de baixo a do horizonte: a rampa cinza puxa para o
+// horizonte nas faces escuras (viradas para o chao) e para o ceu nas claras, e as ultimas entradas
+// saturam na cor do ceu como um reflexo. Saida: header C++ com uint8_t nome[32][3] (RGB 0-31).
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int Entries = 32;
+    constexpr int Neutral = 16;
+    constexpr int Highlight = 26; // a partir daqui vai para a cor do ceu
+
+    struct Color
+    {
+        double rgb[3] = {};
+    };
+
+    bool ReadFile(const char* path, std::vector<uint8_t>& out)
+    {
+        FILE* f = std::fopen(path, "rb");
+        if (f == nullptr) return false;
+        std::fseek(f, 0, SEEK_END);
+        long size = std::ftell(f);
+        std::fseek(f, 0, SEEK_SET);
+        out.resize(size > 0 ? (size_t)size : 0);
+        bool ok = size > 0 && std::fread(out.data(), 1, out.size(), f) == out.size();
+        std::fclose(f);
+        return ok;
+    }
+
+    // Media do terco de cima (ceu) e do terco de baixo (horizonte), em RGB 0-31
+    bool AverageTga(const std::vector<uint8_t>& data, Color& sky, Color& horizon, std::string& error)
+    {
+        if (data.size() < 18) { error = "arquivo curto"; return false; }
+
+        const uint8_t idLength = data[0];
+        const uint8_t colorMapType = data[1];
+        const uint8_t imageType = data[2];
+        const int colorMapFirst = data[3] | (data[4] << 8);
+        const int colorMapLength = data[5] | (data[6] << 8);
+        const int entryBytes = data[7] / 8;
+        const int width = data[12] | (data[13] << 8);
+        const int height = data[14] | (data[15] << 8);
+        const int bpp = data[16];
+        const bool topDown = (data[17] & 0x20) != 0;
+
+        if (colorMapType != 1 || (imageType != 1 && imageType != 9) || bpp != 8 || entryBytes < 3)
+        {
+            error = "esperado TGA 8bpp paletizado (tipo 1 ou 9)";
+            return false;
+        }
+        if (width <= 0 || height < 3) { error = "imagem pequena demais"; return false; }
+
+        Color palette[256];
+        size_t pos = 18 + idLength;
+        if (pos + (size_t)colorMapLength * entryBytes > data.size()) { error = "paleta truncada"; return false; }
+        for (int i = 0; i < colorMapLength && colorMapFirst + i < 256; ++i)
+        {
+            const uint8_t* c = &data[pos + (size_t)i * entryBytes];
+            palette[colorMapFirst + i].rgb[0] = c[2] / 8.0;
+            palette[colorMapFirst + i].rgb[1] = c[1] / 8.0;
+            palette[colorMapFirst + i].rgb[2] = c[0] / 8.0;
+        }
+        pos += (size_t)colorMapLength * entryBytes;
+
+        const size_t total = (size_t)width * height;
+        std::vector<uint8_t> raw;
+        raw.reserve(total);
+        while (raw.size() < total)
+        {
+            if (pos >= data.size()) { error = "dados de imagem truncados"; return false; }
+            if (imageType == 1)
+            {
+                raw.push_back(data[pos++]);
+                continue;
+            }
+
+            const uint8_t header = data[pos++];
+            const int count = (header & 0x7f) + 1;
+            if (header & 0x80)
+            {
+                if (pos >= data.size()) { error = "RLE truncado"; return false; }
+                raw.insert(raw.end(), count, data[pos++]);
+            }
+            else
+            {
+                if (pos + count > data.size()) { error = "RLE truncado"; return false; }
+                raw.insert(raw.end(), data.begin() + pos, data.begin() + pos + count);
+                pos += count;
+            }
+        }
+
+        const int band = height / 3;
+        for (int y = 0; y < band; ++y)
+        {
+            const int top = topDown ? y : (height - 1 - y);
+            const int bottom = topDown ? (height - 1 - y) : y;
+            for (int x = 0; x < width; ++x)
+            {
+                const Color& up = palette[raw[(size_t)top * width + x]];
+                const Color& down = palette[raw[(size_t)bottom * width + x]];
+                for (int c = 0; c < 3; ++c)
+                {
+                    sky.rgb[c] += up.rgb[c];
+                    horizon.rgb[c] += down.rgb[c];
+                }
+            }
+        }
+        for (int c = 0; c < 3; ++c)
+        {
+            sky.rgb[c] /= (double)band * width;
+            horizon.rgb[c] /= (double)band * width;
+        }
+        return true;
+    }
+
+    bool ParseHex(const char* text, Color& color)
+    {
+        if (std::strlen(text) != 7 || text[0] != '#') return false;
+        char* end = nullptr;
+        unsigned long value = std::strtoul(text + 1, &end, 16);
+        if (*end != '\0') return false;
+        color.rgb[0] = ((value >> 16) & 0xff) / 8.0;
+        color.rgb[1] = ((value >> 8) & 0xff) / 8.0;
+        color.rgb[2] = (value & 0xff) / 8.0;
+        return true;
+    }
+
+    // Cor normalizada para luminancia media 1 (so o tom)
+    Color Tint(const Color& color)
+    {
+        double luma = (color.rgb[0] + color.rgb[1] + color.rgb[2]) / 3.0;
+        Color tint;
+        for (int c = 0; c < 3; ++c) tint.rgb[c] = luma > 0.0 ? color.rgb[c] / luma : 1.0;
+        return tint;
+    }
+
+    int Clamp(double value)
+    {
+        int rounded = (int)(value + 0.5);
+        return rounded < 0 ? 0 : (rounded > 31 ? 31 : rounded);
+    }
+
+    void BuildTable(const Color& sky, const Color& horizon, double brightness, int table[Entries][3])
+    {
+        const Color skyTint = Tint(sky);
+        const Color horizonTint = Tint(horizon);
+        const double skyMax = sky.rgb[0] > sky.rgb[1] ? (sky.rgb[0] > sky.rgb[2] ? sky.rgb[0] : sky.rgb[2]) : (sky.rgb[1] > sky.rgb[2] ? sky.rgb[1] : sky.rgb[2]);
+        for (int i = 0; i < Entries; ++i)
+        {
+            const double t = (double)i / (Entries - 1);
+            const double level = i * brightness;
+            for (int c = 0; c < 3; ++c)
+            {
+                // Tom puxado pelo ceu em cima e pelo horizonte embaixo, um quarto sobre o cinza
+                double tint = 0.75 + 0.25 * (horizonTint.rgb[c] + (skyTint.rgb[c] - horizonTint.rgb[c]) * t);
+                double value = level * tint;
+                if (i >= Highlight)
+                {
+                    double k = (double)(i - Highlight + 1) / (Entries - Highlight);
+                    double reflection = skyMax > 0.0 ? sky.rgb[c] * 31.0 / skyMax * brightness : value; // ceu no brilho maximo
+                    value += (reflection - value) * k * 0.5;
+                }
+                table[i][c] = Clamp(value);
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::fprintf(stderr, "uso: %s saida.hpp nome=fonte[@brilho] [...]\n", argv[0]);
+        return 1;
+    }
+
+    std::string out;
+    out += "// Gerado por tools/skylight (nao editar a mao)\n";
+    out += "#pragma once\n\n#include <cstdint>\n\nnamespace LightingTables\n{\n";
+
+    for (int arg = 2; arg < argc; ++arg)
+    {
+        std::string spec = argv[arg];
+        size_t equals = spec.find('=');
+        if (equals == std::string::npos || equals == 0)
+        {
+            std::fprintf(stderr, "%s: esperado nome=fonte\n", spec.c_str());
+            return 1;
+        }
+
+        std::string name = spec.substr(0, equals);
+        std::string source = spec.substr(equals + 1);
+        double brightness = 1.0;
+        size_t at = source.find('@');
+        if (at != std::string::npos)
+        {
+            brightness = std::atoi(source.c_str() + at + 1) / 100.0;
+            source.resize(at);
+        }
+
+        Color sky, horizon;
+        if (source[0] == '#')
+        {
+            if (!ParseHex(source.c_str(), sky))
+            {
+                std::fprintf(stderr, "%s: cor invalida\n", source.c_str());
+                return 1;
+            }
+            horizon = sky;
+        }
+        else
+        {
+            std::vector<uint8_t> tga;
+            std::string error;
+            if (!ReadFile(source.c_str(), tga))
+            {
+                std::fprintf(stderr, "%s: nao foi possivel ler\n", source.c_str());
+                return 1;
+            }
+            if (!AverageTga(tga, sky, horizon, error))
+            {
+                std::fprintf(stderr, "%s: %s\n", source.c_str(), error.c_str());
+                return 1;
+            }
+        }
+
+        int table[Entries][3];
+        BuildTable(sky, horizon, brightness, table);
+
+        const char* file = std::strrchr(source.c_str(), '/');
+        char line[160];
+        std::snprintf(line, sizeof(line), "    // %s: ceu (%.0f, %.0f, %.0f), horizonte (%.0f, %.0f, %.0f), brilho %d%%\n",
+                      file != nullptr ? file + 1 : source.c_str(), sky.rgb[0], sky.rgb[1], sky.rgb[2],
+                      horizon.rgb[0], horizon.rgb[1], horizon.rgb[2], (int)(brightness * 100.0 + 0.5));
+        out += line;
+        out += "    constexpr uint8_t " + name + "[32][3] = {\n";
+        for (int i = 0; i < Entries; i += 4)
+        {
+            out += "       ";
+            for (int k = i; k < i + 4; ++k)
+            {
+                std::snprintf(line, sizeof(line), " {%d, %d, %d},", table[k][0], table[k][1], table[k][2]);
+                out += line;
+            }
+            out += "\n";
+        }
+        out += "    };\n";
+        if (arg + 1 < argc) out += "\n";
+
+        std::printf("%s: %s entrada %d = (%d, %d, %d)\n", name.c_str(), source.c_str(), Neutral,
+                    table[Neutral][0], table[Neutral][1], table[Neutral][2]);
+    }
+    out += "} // namespace LightingTables\n";
+
+    FILE* f = std::fopen(argv[1], "wb");
+    if (f == nullptr || std::fwrite(out.data(), 1, out.size(), f) != out.size())
+    {
+        std::fprintf(stderr, "%s: nao foi possivel gravar\n", argv[1]);
+        if (f != nullptr) std::fclose(f);
+        return 1;
+    }
+    std::fclose(f);
+    return 0;
+}